@@ -0,0 +1,146 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*!
+ * @file
+ *
+ * Catch2 reporter that writes the results of the benchmarks as a JSON
+ * document, so they can be tracked over time.  Use it passing `-r json` to a
+ * benchmark executable.  Times are in nanoseconds per iteration.  Samples
+ * reported with `record_distribution()` are summarized by their percentiles.
+ */
+
+namespace lager {
+namespace bench {
+
+/*!
+ * Summary of a distribution of samples measured by the benchmark itself, like
+ * latencies, that Catch2 can not time.  Values are in nanoseconds.
+ */
+struct distribution
+{
+    std::string name;
+    std::size_t count;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+};
+
+inline std::vector<distribution>& distributions()
+{
+    static auto v = std::vector<distribution>{};
+    return v;
+}
+
+/*!
+ * Adds the percentiles of `samples` to the report.
+ */
+inline void record_distribution(std::string name, std::vector<double> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double p) {
+        auto n = samples.size();
+        return n ? samples[static_cast<std::size_t>(p * (n - 1))] : 0.;
+    };
+    distributions().push_back(
+        {std::move(name), samples.size(), at(.5), at(.9), at(.99), at(1.)});
+}
+
+class json_reporter : public Catch::StreamingReporterBase<json_reporter>
+{
+    struct result
+    {
+        std::string test_case;
+        Catch::BenchmarkStats<> stats;
+    };
+
+    std::vector<result> results_;
+
+public:
+    using Catch::StreamingReporterBase<json_reporter>::StreamingReporterBase;
+
+    static std::string getDescription()
+    {
+        return "Reports the benchmark results as JSON";
+    }
+
+    void assertionStarting(const Catch::AssertionInfo&) override {}
+    bool assertionEnded(const Catch::AssertionStats&) override { return true; }
+
+    void benchmarkEnded(const Catch::BenchmarkStats<>& stats) override
+    {
+        results_.push_back({currentTestCaseInfo->name, stats});
+    }
+
+    void testRunEnded(const Catch::TestRunStats& stats) override
+    {
+        auto& out = stream;
+        out << "{\"executable\":";
+        write_string(currentTestRunInfo->name);
+        out << ",\"benchmarks\":[";
+        auto first = true;
+        for (auto& r : results_) {
+            auto& s = r.stats;
+            out << (first ? "\n" : ",\n") << "{\"test_case\":";
+            write_string(r.test_case);
+            out << ",\"name\":";
+            write_string(s.info.name);
+            out << ",\"samples\":" << s.info.samples
+                << ",\"iterations\":" << s.info.iterations
+                << ",\"mean\":" << s.mean.point.count()
+                << ",\"mean_lower\":" << s.mean.lower_bound.count()
+                << ",\"mean_upper\":" << s.mean.upper_bound.count()
+                << ",\"stddev\":" << s.standardDeviation.point.count()
+                << ",\"outlier_variance\":" << s.outlierVariance << "}";
+            first = false;
+        }
+        out << "\n],\"distributions\":[";
+        first = true;
+        for (auto& d : distributions()) {
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            write_string(d.name);
+            out << ",\"count\":" << d.count << ",\"p50\":" << d.p50
+                << ",\"p90\":" << d.p90 << ",\"p99\":" << d.p99
+                << ",\"max\":" << d.max << "}";
+            first = false;
+        }
+        out << "\n]}\n";
+        StreamingReporterBase::testRunEnded(stats);
+    }
+
+private:
+    void write_string(const std::string& s)
+    {
+        stream << '"';
+        for (auto c : s) {
+            if (c == '"' || c == '\\')
+                stream << '\\';
+            stream << c;
+        }
+        stream << '"';
+    }
+};
+
+CATCH_REGISTER_REPORTER("json", json_reporter)
+
+} // namespace bench
+} // namespace lager
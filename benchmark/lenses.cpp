@@ -0,0 +1,98 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include "json_reporter.hpp"
+
+#include <immer/vector.hpp>
+
+#include <lager/commit.hpp>
+#include <lager/cursor.hpp>
+#include <lager/lenses.hpp>
+#include <lager/lenses/at.hpp>
+#include <lager/lenses/attr.hpp>
+#include <lager/lenses/optional.hpp>
+#include <lager/state.hpp>
+
+#include <optional>
+#include <string>
+
+using namespace lager;
+using namespace lager::lenses;
+
+namespace {
+
+struct item
+{
+    std::string name;
+    std::optional<int> done;
+};
+
+struct model
+{
+    immer::vector<item> items;
+    int counter;
+};
+
+model make_model(std::size_t n)
+{
+    auto items = immer::vector<item>{};
+    for (auto i = std::size_t{}; i < n; ++i)
+        items = std::move(items).push_back({std::to_string(i), {}});
+    return {items, 0};
+}
+
+const auto counter_lens = attr(&model::counter);
+const auto name_lens =
+    attr(&model::items) | at(500) | force_opt | attr(&item::name);
+const auto done_lens = attr(&model::items) | at(500) |
+                       with_opt(attr(&item::done)) | or_default;
+
+} // namespace
+
+TEST_CASE("lens")
+{
+    auto m = make_model(1000);
+
+    BENCHMARK("attr/view") { return view(counter_lens, m); };
+    BENCHMARK("attr/set") { return set(counter_lens, m, 42).counter; };
+    BENCHMARK("at/view") { return view(name_lens, m); };
+    BENCHMARK("at/set") { return set(name_lens, m, "foo").items.size(); };
+    BENCHMARK("optional/view") { return view(done_lens, m); };
+    BENCHMARK("optional/set") { return set(done_lens, m, 42).items.size(); };
+}
+
+TEST_CASE("cursor")
+{
+    auto st      = make_state(make_model(1000));
+    auto counter = cursor<int>{st.zoom(counter_lens)};
+    auto name    = cursor<std::string>{st.zoom(name_lens)};
+    auto done    = cursor<int>{st.zoom(done_lens)};
+
+    BENCHMARK("attr/get") { return counter.get(); };
+    BENCHMARK("attr/set")
+    {
+        counter.set(counter.get() + 1);
+        commit(st);
+    };
+    BENCHMARK("at/get") { return name.get(); };
+    BENCHMARK("at/set")
+    {
+        name.set(name.get() == "foo" ? "bar" : "foo");
+        commit(st);
+    };
+    BENCHMARK("optional/get") { return done.get(); };
+    BENCHMARK("optional/set")
+    {
+        done.set(done.get() + 1);
+        commit(st);
+    };
+}
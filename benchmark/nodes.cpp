@@ -0,0 +1,178 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include "json_reporter.hpp"
+
+#include <lager/commit.hpp>
+#include <lager/reader.hpp>
+#include <lager/state.hpp>
+#include <lager/watch.hpp>
+#include <lager/with.hpp>
+
+#include <vector>
+
+using namespace lager;
+
+namespace {
+
+auto inc = [](int x) { return x + 1; };
+
+std::vector<reader<int>> make_chain(const state<int>& root, int depth)
+{
+    auto result = std::vector<reader<int>>{root};
+    for (auto i = 0; i < depth; ++i)
+        result.push_back(result.back().map(inc).make());
+    return result;
+}
+
+std::vector<reader<int>> make_fan_out(const state<int>& root, int width)
+{
+    auto result = std::vector<reader<int>>{};
+    for (auto i = 0; i < width; ++i)
+        result.push_back(root.map(inc).make());
+    return result;
+}
+
+// Filters that reject the initial value, as in per-row views of which only
+// some rows are visible.
+std::vector<reader<int>> make_filtered(const state<int>& root, int width)
+{
+    auto result = std::vector<reader<int>>{};
+    for (auto i = 0; i < width; ++i)
+        result.push_back(root.filter([i](int x) { return x == i; }).make());
+    return result;
+}
+
+reader<int> make_diamonds(const state<int>& root, int depth)
+{
+    auto result = reader<int>{root};
+    for (auto i = 0; i < depth; ++i) {
+        auto l = result.map(inc).make();
+        auto r = result.map(inc).make();
+        result = with(l, r).map([](int a, int b) { return a + b; }).make();
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("construction")
+{
+    for (auto n : {10, 100, 1000}) {
+        auto root = make_state(0);
+        BENCHMARK("chain/" + std::to_string(n))
+        {
+            return make_chain(root, n).size();
+        };
+        BENCHMARK("fan-out/" + std::to_string(n))
+        {
+            return make_fan_out(root, n).size();
+        };
+        BENCHMARK("filtered/" + std::to_string(n))
+        {
+            return make_filtered(root, n).size();
+        };
+        BENCHMARK_ADVANCED("teardown/" + std::to_string(n))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            auto chains = std::vector<std::vector<reader<int>>>{};
+            for (auto i = 0; i < meter.runs(); ++i)
+                chains.push_back(make_chain(root, n));
+            meter.measure([&](int i) { chains[i].clear(); });
+        };
+    }
+}
+
+TEST_CASE("propagation")
+{
+    for (auto n : {10, 100, 1000}) {
+        BENCHMARK_ADVANCED("chain/" + std::to_string(n))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            auto root  = make_state(0);
+            auto chain = make_chain(root, n);
+            meter.measure([&](int i) {
+                root.set(i);
+                commit(root);
+                return chain.back().get();
+            });
+        };
+        BENCHMARK_ADVANCED("fan-out/" + std::to_string(n))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            auto root     = make_state(0);
+            auto children = make_fan_out(root, n);
+            meter.measure([&](int i) {
+                root.set(i);
+                commit(root);
+                return children.back().get();
+            });
+        };
+    }
+    for (auto n : {2, 8, 32}) {
+        BENCHMARK_ADVANCED("diamonds/" + std::to_string(n))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            auto root = make_state(0);
+            auto last = make_diamonds(root, n);
+            meter.measure([&](int i) {
+                root.set(i);
+                commit(root);
+                return last.get();
+            });
+        };
+    }
+    BENCHMARK_ADVANCED("unchanged/1000")(Catch::Benchmark::Chronometer meter)
+    {
+        auto root  = make_state(0);
+        auto chain = make_chain(root, 1000);
+        meter.measure([&] {
+            root.set(0);
+            commit(root);
+            return chain.back().get();
+        });
+    };
+}
+
+TEST_CASE("watchers")
+{
+    for (auto n : {1, 10, 100, 1000}) {
+        BENCHMARK_ADVANCED("dispatch/" + std::to_string(n))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            auto root     = make_state(0);
+            auto sum      = 0;
+            auto watchers = std::vector<reader<int>>(n, root);
+            for (auto& w : watchers)
+                w.watch([&](int x) { sum += x; });
+            meter.measure([&](int i) {
+                root.set(i);
+                commit(root);
+                return sum;
+            });
+        };
+        BENCHMARK_ADVANCED("leaves/" + std::to_string(n))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            auto root     = make_state(0);
+            auto sum      = 0;
+            auto children = make_fan_out(root, n);
+            for (auto& c : children)
+                c.watch([&](int x) { sum += x; });
+            meter.measure([&](int i) {
+                root.set(i);
+                commit(root);
+                return sum;
+            });
+        };
+    }
+}
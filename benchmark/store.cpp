@@ -0,0 +1,321 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include "json_reporter.hpp"
+
+#include <lager/event_loop/boost_asio.hpp>
+#include <lager/event_loop/manual.hpp>
+#include <lager/event_loop/queue.hpp>
+#include <lager/event_loop/safe_queue.hpp>
+#include <lager/store.hpp>
+
+#include <immer/flex_vector_transient.hpp>
+#include <immer/map.hpp>
+
+#include "../example/autopong/autopong.hpp"
+#include "../example/counter/counter.hpp"
+#include "../example/todo/model.hpp"
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace lager;
+
+namespace {
+
+constexpr auto batch_size = 1000;
+
+// Event loops
+// ===========
+
+struct manual_loop
+{
+    static constexpr auto name = "manual";
+    auto handle() { return with_manual_event_loop{}; }
+    void run() {}
+};
+
+struct queue_loop
+{
+    static constexpr auto name = "queue";
+    queue_event_loop queue;
+    auto handle() { return with_queue_event_loop{queue}; }
+    void run() { queue.step(); }
+};
+
+struct safe_queue_loop
+{
+    static constexpr auto name = "safe_queue";
+    safe_queue_event_loop queue;
+    auto handle() { return with_safe_queue_event_loop{queue}; }
+    void run() { queue.step(); }
+};
+
+struct asio_loop
+{
+    static constexpr auto name = "boost_asio";
+    boost::asio::io_context context;
+    auto handle()
+    {
+        return with_boost_asio_event_loop{context.get_executor()};
+    }
+    void run()
+    {
+        context.run();
+        context.restart();
+    }
+};
+
+// Models
+// ======
+
+struct counter_bench
+{
+    static constexpr auto name = "counter";
+    using action_t             = counter::action;
+    static auto init() { return counter::model{}; }
+    static auto reducer() { return counter::update; }
+    static action_t action(int) { return counter::increment_action{}; }
+};
+
+struct autopong_bench
+{
+    static constexpr auto name = "autopong";
+    using action_t             = autopong::action;
+    static auto init() { return autopong::model{}; }
+    static auto reducer() { return autopong::update; }
+    static action_t action(int) { return autopong::tick_action{1.f}; }
+};
+
+struct todo_bench
+{
+    static constexpr auto name = "todo-1M";
+    static constexpr auto size = std::size_t{1'000'000};
+    using action_t             = todo::model_action;
+
+    static auto init()
+    {
+        auto todos = immer::flex_vector<todo::item>{}.transient();
+        for (auto i = std::size_t{}; i < size; ++i)
+            todos.push_back({false, std::to_string(i)});
+        return todo::model{todos.persistent()};
+    }
+    static auto reducer()
+    {
+        return [](todo::model m, todo::model_action a) {
+            return todo::update(std::move(m), std::move(a));
+        };
+    }
+    static action_t action(int i)
+    {
+        return std::pair{std::size_t(i) * 7919 % size,
+                         todo::item_action{todo::toggle_item_action{}}};
+    }
+};
+
+struct todo_index_bench
+{
+    static constexpr auto name = "todo-map-100k";
+    static constexpr auto size = std::size_t{100'000};
+    using model_t              = immer::map<std::size_t, todo::item>;
+    using action_t             = std::size_t;
+
+    static auto init()
+    {
+        auto todos = model_t{};
+        for (auto i = std::size_t{}; i < size; ++i)
+            todos = std::move(todos).set(i, {false, std::to_string(i)});
+        return todos;
+    }
+    static auto reducer()
+    {
+        return [](model_t m, std::size_t k) {
+            return std::move(m).update(k, [](todo::item x) {
+                x.done = !x.done;
+                return x;
+            });
+        };
+    }
+    static action_t action(int i) { return std::size_t(i) * 7919 % size; }
+};
+
+// Store variants
+// ==============
+
+template <typename Model>
+auto with_effect()
+{
+    return [](auto m, auto a) {
+        return std::pair{Model::reducer()(std::move(m), std::move(a)),
+                         [](auto&&) {}};
+    };
+}
+
+template <typename Model, typename Loop, typename Tag = automatic_tag>
+auto make_plain_store(Loop& loop)
+{
+    return make_store<typename Model::action_t, Tag>(
+        Model::init(), loop.handle(), with_reducer(Model::reducer()));
+}
+
+template <typename Model, typename Loop>
+auto make_effect_store(Loop& loop)
+{
+    return make_store<typename Model::action_t>(
+        Model::init(), loop.handle(), with_reducer(with_effect<Model>()));
+}
+
+template <typename Model, typename Loop>
+auto make_futures_store(Loop& loop)
+{
+    return make_store<typename Model::action_t>(
+        Model::init(),
+        loop.handle(),
+        with_reducer(with_effect<Model>()),
+        with_futures);
+}
+
+template <typename Loop, typename Model, typename MakeStore>
+void throughput(const std::string& variant, MakeStore make)
+{
+    // The models can be expensive to build, so the store is shared by all the
+    // samples.
+    auto loop  = Loop{};
+    auto store = make(loop);
+    BENCHMARK_ADVANCED(std::string{Loop::name} + "/" + Model::name + "/" +
+                       variant)
+    (Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure([&](int run) {
+            for (auto i = 0; i < batch_size; ++i)
+                store.dispatch(Model::action(run * batch_size + i));
+            loop.run();
+            return &store.get();
+        });
+    };
+}
+
+template <typename Loop, typename Model>
+void throughput_all()
+{
+    throughput<Loop, Model>("plain", [](auto& l) {
+        return make_plain_store<Model>(l);
+    });
+    throughput<Loop, Model>("effect", [](auto& l) {
+        return make_effect_store<Model>(l);
+    });
+    throughput<Loop, Model>("futures", [](auto& l) {
+        return make_futures_store<Model>(l);
+    });
+}
+
+/*!
+ * Measures the time from `dispatch()` until the watchers see the new model.
+ * Actions are dispatched in bursts, so the latency includes the time they wait
+ * in the event loop behind the actions that were dispatched before them.
+ *
+ * On queued event loops, all the actions of a burst may be reduced before the
+ * watchers run, so a notification is matched with every action reduced since
+ * the previous one.
+ */
+template <typename Loop, typename Model>
+void latency(int rounds = 200, int burst = 16)
+{
+    using clock_t   = std::chrono::steady_clock;
+    auto loop       = Loop{};
+    auto reduced    = std::size_t{};
+    auto observed   = std::size_t{};
+    auto dispatched = std::deque<clock_t::time_point>{};
+    auto samples    = std::vector<double>{};
+    auto store      = make_store<typename Model::action_t>(
+        Model::init(), loop.handle(), with_reducer([&](auto m, auto a) {
+            ++reduced;
+            return Model::reducer()(std::move(m), std::move(a));
+        }));
+    watch(store, [&](auto&&) {
+        auto now = clock_t::now();
+        for (; observed < reduced; ++observed) {
+            samples.push_back(std::chrono::duration<double, std::nano>(
+                                  now - dispatched.front())
+                                  .count());
+            dispatched.pop_front();
+        }
+    });
+    for (auto r = 0; r < rounds; ++r) {
+        for (auto i = 0; i < burst; ++i) {
+            dispatched.push_back(clock_t::now());
+            store.dispatch(Model::action(r * burst + i));
+        }
+        loop.run();
+    }
+    bench::record_distribution(std::string{"latency/"} + Loop::name + "/" +
+                                   Model::name,
+                               std::move(samples));
+}
+
+template <typename Loop>
+void latency_all()
+{
+    latency<Loop, counter_bench>();
+    latency<Loop, autopong_bench>();
+    latency<Loop, todo_bench>();
+    latency<Loop, todo_index_bench>();
+}
+
+} // namespace
+
+TEST_CASE("throughput")
+{
+    throughput_all<manual_loop, counter_bench>();
+    throughput_all<queue_loop, counter_bench>();
+    throughput_all<safe_queue_loop, counter_bench>();
+    throughput_all<asio_loop, counter_bench>();
+
+    throughput_all<manual_loop, autopong_bench>();
+    throughput_all<queue_loop, autopong_bench>();
+
+    throughput_all<manual_loop, todo_bench>();
+    throughput_all<queue_loop, todo_bench>();
+
+    throughput_all<manual_loop, todo_index_bench>();
+    throughput_all<queue_loop, todo_index_bench>();
+}
+
+TEST_CASE("transactional")
+{
+    // Commits once per batch, so watchers are notified only once.
+    BENCHMARK_ADVANCED("queue/counter/commit")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        auto loop  = queue_loop{};
+        auto store =
+            make_plain_store<counter_bench, queue_loop, transactional_tag>(
+                loop);
+        meter.measure([&] {
+            for (auto i = 0; i < batch_size; ++i)
+                store.dispatch(counter_bench::action(i));
+            loop.run();
+            commit(store);
+            return store.get().value;
+        });
+    };
+}
+
+TEST_CASE("latency")
+{
+    latency_all<manual_loop>();
+    latency_all<queue_loop>();
+    latency_all<safe_queue_loop>();
+    latency_all<asio_loop>();
+}
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <lager/detail/access.hpp>
+#include <lager/detail/write_batch.hpp>
 #include <lager/util.hpp>
 
 namespace lager {
@@ -36,10 +37,15 @@ void notify_root(RootCursorT&& root)
  * Commit changes to a series of root cursors.  All values from the root cursors
  * are propagated before notifying any watchers.  This ensures that watchers
  * always see a consistent state of the world.
+ *
+ * The writes of the `write_batch` that is open in the current thread, if any,
+ * are flushed first.
  */
 template <typename... RootCursorTs>
 void commit(RootCursorTs&&... roots)
 {
+    if (auto batch = detail::write_batch_state::current())
+        batch->flush();
     (detail::send_down_root(std::forward<RootCursorTs>(roots)), ...);
     (detail::notify_root(std::forward<RootCursorTs>(roots)), ...);
 }
@@ -33,6 +33,8 @@
 #endif
 
 #ifdef LAGER_NO_EXCEPTIONS
+#include <cassert>
+#include <exception>
 #define LAGER_TRY if (true)
 #define LAGER_CATCH(expr) else
 #define LAGER_THROW(expr)                                                      \
@@ -27,6 +27,8 @@ class constant_node : public root_node<T, reader_node>
 public:
     using base_t::base_t;
 
+    LAGER_DETAIL_NODE_KIND("constant")
+
     virtual void recompute() final {}
 };
 
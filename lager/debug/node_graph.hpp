@@ -0,0 +1,193 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/access.hpp>
+#include <lager/detail/nodes.hpp>
+
+#include <boost/core/demangle.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lager {
+
+//! @defgroup node-graph
+//! @{
+
+/*!
+ * Information about a node of the graph of derived cursors and readers.
+ */
+struct node_report
+{
+    //! Position of the node in `node_graph::nodes`.
+    std::size_t id;
+    //! One of `store`, `state`, `sensor`, `constant`, `lens`, `xform`,
+    //! `merge` or `setter`.
+    std::string kind;
+    std::string value_type;
+    std::size_t recomputes;
+    //! Number of recomputations that produced a new value.
+    std::size_t changes;
+    std::chrono::nanoseconds recompute_time;
+    //! Number of readers and cursors that watch the node.
+    std::size_t observers;
+    std::vector<std::size_t> children;
+};
+
+/*!
+ * A snapshot of a graph of nodes, as returned by `inspect_node_graph()`.  The
+ * nodes are sorted in breadth first order from the roots.
+ */
+struct node_graph
+{
+    std::vector<node_report> nodes;
+};
+
+/*!
+ * Collects the nodes reachable from `roots`, which are stores, states or any
+ * other reader or cursor, together with the statistics of their
+ * recomputations.
+ *
+ * The statistics are only collected when the library is compiled with
+ * `LAGER_ENABLE_NODE_STATS`.  Otherwise, nodes carry no instrumentation and
+ * this returns an empty graph.
+ */
+template <typename... Roots>
+node_graph inspect_node_graph(const Roots&... roots)
+{
+    auto result = node_graph{};
+#ifdef LAGER_ENABLE_NODE_STATS
+    using node_ptr_t = std::shared_ptr<detail::reader_node_base>;
+    auto ids         = std::unordered_map<const void*, std::size_t>{};
+    auto pending     = std::vector<node_ptr_t>{};
+    auto visit       = [&](node_ptr_t n) {
+        auto [it, inserted] = ids.emplace(n.get(), ids.size());
+        if (inserted)
+            pending.push_back(std::move(n));
+        return it->second;
+    };
+    (visit(detail::access::node(roots)), ...);
+    for (auto i = std::size_t{}; i < pending.size(); ++i) {
+        auto n           = pending[i];
+        auto stats       = n->stats();
+        auto r           = node_report{};
+        r.id             = i;
+        r.kind           = n->node_kind();
+        r.value_type     = boost::core::demangle(n->node_value_type().name());
+        r.recomputes     = stats.recomputes;
+        r.changes        = stats.changes;
+        r.recompute_time = stats.recompute_time;
+        r.observers      = n->observer_count();
+        for (auto& child : n->child_nodes())
+            r.children.push_back(visit(child));
+        result.nodes.push_back(std::move(r));
+    }
+#else
+    (static_cast<void>(roots), ...);
+#endif
+    return result;
+}
+
+namespace detail {
+
+/*!
+ * Writes a quoted string with the escaping rules shared by JSON and DOT.
+ */
+inline void write_node_graph_string(std::ostream& out, const std::string& s)
+{
+    out << '"';
+    for (auto c : s) {
+        switch (c) {
+        case '\n':
+            out << "\\n";
+            break;
+        case '"':
+        case '\\':
+            out << '\\' << c;
+            break;
+        default:
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace detail
+
+/*!
+ * Writes the graph in the [DOT](https://graphviz.org) language.  Nodes that
+ * spend more time recomputing are drawn with a thicker border.
+ */
+inline void write_dot(std::ostream& out, const node_graph& graph)
+{
+    auto max_time = std::chrono::nanoseconds{};
+    for (auto& n : graph.nodes)
+        max_time = std::max(max_time, n.recompute_time);
+
+    out << "digraph lager {\n"
+        << "  node [shape=box, fontname=monospace];\n";
+    for (auto& n : graph.nodes) {
+        auto changed = n.recomputes ? 100 * n.changes / n.recomputes : 0;
+        auto width   = max_time.count() ? 1 + 4 * n.recompute_time.count() /
+                                                max_time.count()
+                                          : 1;
+        out << "  n" << n.id << " [label=";
+        detail::write_node_graph_string(
+            out,
+            n.kind + ": " + n.value_type +
+                "\nrecomputes: " + std::to_string(n.recomputes) + " (" +
+                std::to_string(changed) + "% changed)" +
+                "\ntime: " + std::to_string(n.recompute_time.count()) +
+                "ns\nobservers: " + std::to_string(n.observers));
+        out << ", penwidth=" << width << "];\n";
+    }
+    for (auto& n : graph.nodes)
+        for (auto child : n.children)
+            out << "  n" << n.id << " -> n" << child << ";\n";
+    out << "}\n";
+}
+
+/*!
+ * Writes the graph as a JSON document, with a `nodes` array containing one
+ * object per `node_report`.  Times are in nanoseconds.
+ */
+inline void write_json(std::ostream& out, const node_graph& graph)
+{
+    out << "{\"nodes\":[";
+    auto first = true;
+    for (auto& n : graph.nodes) {
+        out << (first ? "\n" : ",\n") << "{\"id\":" << n.id << ",\"kind\":";
+        detail::write_node_graph_string(out, n.kind);
+        out << ",\"value_type\":";
+        detail::write_node_graph_string(out, n.value_type);
+        out << ",\"recomputes\":" << n.recomputes
+            << ",\"changes\":" << n.changes
+            << ",\"recompute_time\":" << n.recompute_time.count()
+            << ",\"observers\":" << n.observers << ",\"children\":[";
+        for (auto i = std::size_t{}; i < n.children.size(); ++i)
+            out << (i ? "," : "") << n.children[i];
+        out << "]}";
+        first = false;
+    }
+    out << "\n]}\n";
+}
+
+//! @} group: node-graph
+
+} // namespace lager
@@ -0,0 +1,164 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+namespace lager {
+
+/*!
+ * Frame time statistics collected by event loops that run a `tick` function
+ * at a target frame rate.  Times are in milliseconds and percentiles are
+ * computed over the most recent frames.
+ */
+struct frame_stats
+{
+    //! Total number of frames measured.
+    std::size_t frames = 0;
+    //! Frames whose work took longer than the target frame time.
+    std::size_t dropped_frames = 0;
+    //! Frames in which some posted closures were deferred to the next frame
+    //! because the budget was exceeded.
+    std::size_t deferred_frames = 0;
+    //! Work time per frame, this is, handling events, evaluating posted
+    //! closures, which includes reducers, effects and watchers, and the
+    //! `tick` function, which normally renders.  Waiting for the next frame
+    //! is not included.
+    float frame_p50 = 0;
+    float frame_p99 = 0;
+    float frame_max = 0;
+    //! Time per frame spent in posted closures only.
+    float posts_p50 = 0;
+    float posts_p99 = 0;
+};
+
+namespace detail {
+
+/*!
+ * Measures the work done in every frame of an event loop and decides how much
+ * time can be spent in posted closures.  The closures get whatever is left of
+ * the budget since the beginning of the frame, after handling the events.
+ */
+template <typename Clock = std::chrono::steady_clock>
+class frame_scheduler
+{
+    using time_point = typename Clock::time_point;
+
+    static constexpr std::size_t window = 256;
+
+    float target_ms_        = 0;
+    float budget_ms_        = 0;
+    time_point frame_start_ = {};
+    float posts_ms_         = 0;
+    float idle_ms_          = 0;
+    bool deferred_          = false;
+
+    frame_stats stats_;
+    std::array<float, window> frame_samples_{};
+    std::array<float, window> posts_samples_{};
+
+    static float elapsed_ms(time_point since)
+    {
+        return std::chrono::duration<float, std::milli>(Clock::now() - since)
+            .count();
+    }
+
+    static float percentile(std::array<float, window> samples,
+                            std::size_t count,
+                            float p)
+    {
+        auto n = std::min(count, window);
+        if (n == 0)
+            return 0;
+        auto nth = samples.begin() + static_cast<std::size_t>(p * (n - 1));
+        std::nth_element(samples.begin(), nth, samples.begin() + n);
+        return *nth;
+    }
+
+public:
+    void start(float target_ms) { target_ms_ = target_ms; }
+
+    /*!
+     * Budget per frame for handling events and posted closures.  When zero,
+     * half of the target frame time is used.
+     */
+    float budget() const
+    {
+        return budget_ms_ > 0 ? budget_ms_ : target_ms_ / 2;
+    }
+    void set_budget(float ms) { budget_ms_ = ms; }
+
+    void begin_frame()
+    {
+        frame_start_ = Clock::now();
+        posts_ms_    = 0;
+        idle_ms_     = 0;
+        deferred_    = false;
+    }
+
+    /*!
+     * Calls `drain` with the time left until the deadline of the frame,
+     * possibly zero.  It must return whether some closures were deferred.
+     */
+    template <typename Fn>
+    void run_posts(Fn&& drain)
+    {
+        auto start = Clock::now();
+        auto left  = std::max(0.f, budget() - elapsed_ms(frame_start_));
+        deferred_  = std::forward<Fn>(drain)(left) || deferred_;
+        posts_ms_ += elapsed_ms(start);
+    }
+
+    /*!
+     * Calls `fn`, which waits for the deadline of the frame, and returns its
+     * result.  The time spent in it is not counted as work of the frame.
+     */
+    template <typename Fn>
+    auto idle(Fn&& fn)
+    {
+        auto start  = Clock::now();
+        auto result = std::forward<Fn>(fn)();
+        idle_ms_ += elapsed_ms(start);
+        return result;
+    }
+
+    void end_frame()
+    {
+        auto frame_ms = elapsed_ms(frame_start_) - idle_ms_;
+        auto slot     = stats_.frames++ % window;
+        frame_samples_[slot] = frame_ms;
+        posts_samples_[slot] = posts_ms_;
+        stats_.frame_max     = std::max(stats_.frame_max, frame_ms);
+        stats_.dropped_frames += frame_ms > target_ms_;
+        stats_.deferred_frames += deferred_;
+    }
+
+    frame_stats stats() const
+    {
+        auto r      = stats_;
+        r.frame_p50 = percentile(frame_samples_, r.frames, 0.5f);
+        r.frame_p99 = percentile(frame_samples_, r.frames, 0.99f);
+        r.posts_p50 = percentile(posts_samples_, r.frames, 0.5f);
+        r.posts_p99 = percentile(posts_samples_, r.frames, 0.99f);
+        return r;
+    }
+};
+
+} // namespace detail
+
+} // namespace lager
@@ -14,6 +14,7 @@
 
 #include <lager/detail/no_value.hpp>
 #include <lager/detail/nodes.hpp>
+#include <lager/detail/write_batch.hpp>
 #include <lager/util.hpp>
 
 #include <zug/meta.hpp>
@@ -60,6 +61,8 @@ public:
         , lens_{std::forward<Lens2>(l)}
     {}
 
+    LAGER_DETAIL_NODE_KIND("lens")
+
     void recompute() final
     {
         this->push_down(view(lens_, current_from(this->parents())));
@@ -73,11 +76,19 @@ class lens_cursor_node;
 template <typename Lens, typename ParentsPack>
 using lens_cursor_base = lens_reader_node<Lens, ParentsPack, cursor_node>;
 
+template <typename... Parents>
+using lens_parents_value_t = std::decay_t<decltype(
+    zug::tuplify(std::declval<zug::meta::value_t<Parents>>()...))>;
+
 template <typename Lens, typename... Parents>
 class lens_cursor_node<Lens, zug::meta::pack<Parents...>>
     : public lens_cursor_base<Lens, zug::meta::pack<Parents...>>
+    , public batched_child_node<lens_parents_value_t<Parents...>>
+    , public std::enable_shared_from_this<
+          lens_cursor_node<Lens, zug::meta::pack<Parents...>>>
 {
-    using base_t = lens_cursor_base<Lens, zug::meta::pack<Parents...>>;
+    using base_t  = lens_cursor_base<Lens, zug::meta::pack<Parents...>>;
+    using whole_t = lens_parents_value_t<Parents...>;
 
 public:
     using value_type = typename base_t::value_type;
@@ -86,15 +97,69 @@ public:
 
     void send_up(const value_type& value) final
     {
+        write_barrier(this->depth());
         this->refresh();
-        this->push_up(set(this->lens_, current_from(this->parents()), value));
+        if (auto batch = write_batch_state::current()) {
+            this->push_down(value);
+            batch->add(this->depth(), this->shared_from_this());
+        } else {
+            this->push_up(
+                set(this->lens_, current_from(this->parents()), value));
+        }
     }
 
     void send_up(value_type&& value) final
     {
+        write_barrier(this->depth());
         this->refresh();
-        this->push_up(
-            set(this->lens_, current_from(this->parents()), std::move(value)));
+        if (auto batch = write_batch_state::current()) {
+            this->push_down(std::move(value));
+            batch->add(this->depth(), this->shared_from_this());
+        } else {
+            this->push_up(set(
+                this->lens_, current_from(this->parents()), std::move(value)));
+        }
+    }
+
+    /*!
+     * Applies the values that were written during a batch to the parents,
+     * which are updated only once for all the siblings in the `group`.  The
+     * nodes themselves are not refreshed, because that would recompute their
+     * values from the parents, losing the writes.
+     */
+    void flush_up(const std::vector<batched_writer_node*>& group) final
+    {
+        refresh_parents();
+        auto whole = whole_t{current_from(this->parents())};
+        for (auto node : group)
+            static_cast<batched_child_node<whole_t>*>(node)->write_into(whole);
+        this->push_up(std::move(whole));
+    }
+
+    void discard_up() final
+    {
+        refresh_parents();
+        this->recompute();
+    }
+
+    const void* batch_parent() const final
+    {
+        if constexpr (sizeof...(Parents) == 1)
+            return std::get<0>(this->parents()).get();
+        else
+            return nullptr;
+    }
+
+    void write_into(whole_t& whole) const final
+    {
+        whole = set(this->lens_, std::move(whole), this->current_);
+    }
+
+private:
+    void refresh_parents()
+    {
+        std::apply([&](auto&&... ps) { noop((ps->refresh(), 0)...); },
+                   this->parents());
     }
 };
 
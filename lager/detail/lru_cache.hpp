@@ -0,0 +1,133 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace lager {
+namespace detail {
+
+/*!
+ * Hashes values with `std::hash` and tuples of them combining the hashes of
+ * their elements.
+ */
+struct memo_hash
+{
+    template <typename T>
+    std::size_t operator()(const T& x) const
+    {
+        return std::hash<T>{}(x);
+    }
+
+    template <typename... Ts>
+    std::size_t operator()(const std::tuple<Ts...>& x) const
+    {
+        // use formula from boost::hash_combine, like LAGER_DERIVE(HASH)
+        auto seed = std::size_t{};
+        std::apply(
+            [&](auto&... xs) {
+                ((seed ^= (*this)(xs) + 0x9e3779b9 + (seed << 6) + (seed >> 2)),
+                 ...);
+            },
+            x);
+        return seed;
+    }
+};
+
+/*!
+ * Map with a bounded number of entries, that evicts the least recently used
+ * one when it is full.
+ */
+template <typename Key,
+          typename Value,
+          typename Hash  = memo_hash,
+          typename Equal = std::equal_to<Key>>
+class lru_cache
+{
+    using order_t = std::list<const Key*>;
+
+    struct entry
+    {
+        Value value;
+        typename order_t::iterator order;
+    };
+
+    // Nodes of the map are stable, so the order can point into their keys.
+    std::unordered_map<Key, entry, Hash, Equal> entries_;
+    order_t order_;
+    std::size_t capacity_;
+
+public:
+    lru_cache(std::size_t capacity)
+        : capacity_{capacity}
+    {
+        assert(capacity_ > 0 && "The cache must be able to hold some value");
+        entries_.reserve(capacity_);
+    }
+
+    std::size_t size() const { return entries_.size(); }
+    std::size_t capacity() const { return capacity_; }
+
+    /*!
+     * Returns the value associated to `key`, marking it as recently used, or
+     * null if there is none.
+     */
+    const Value* find(const Key& key)
+    {
+        auto it = entries_.find(key);
+        if (it == entries_.end())
+            return nullptr;
+        order_.splice(order_.begin(), order_, it->second.order);
+        return &it->second.value;
+    }
+
+    /*!
+     * Associates `value` to `key`, which must not be in the cache, evicting
+     * the least recently used entry when it is full.
+     */
+    const Value& insert(Key key, Value value)
+    {
+        assert(!entries_.count(key) && "The key is already in the cache");
+        if (entries_.size() == capacity_) {
+            entries_.erase(*order_.back());
+            order_.pop_back();
+        }
+        auto it = entries_.emplace(std::move(key), entry{std::move(value), {}})
+                      .first;
+        order_.push_front(&it->first);
+        it->second.order = order_.begin();
+        return it->second.value;
+    }
+
+    /*!
+     * Returns the value associated to `key`, computing it with `fn` when it is
+     * not in the cache.  Nothing is evicted when `fn` throws.
+     */
+    template <typename Fn>
+    const Value& get(Key key, Fn&& fn)
+    {
+        if (auto v = find(key))
+            return *v;
+        auto value = std::invoke(std::forward<Fn>(fn));
+        return insert(std::move(key), std::move(value));
+    }
+};
+
+} // namespace detail
+} // namespace lager
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <lager/detail/nodes.hpp>
+#include <lager/detail/write_batch.hpp>
 #include <lager/util.hpp>
 
 #include <zug/meta.hpp>
@@ -21,6 +22,10 @@
 #include <zug/tuplify.hpp>
 #include <zug/util.hpp>
 
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
 namespace lager {
 namespace detail {
 
@@ -49,7 +54,48 @@ public:
         : base_t{current_from(parents), std::forward<ParentsTuple>(parents)}
     {}
 
-    void recompute() final { this->push_down(current_from(this->parents())); }
+    LAGER_DETAIL_NODE_KIND("merge")
+
+    void recompute() final
+    {
+        if constexpr (sizeof...(Parents) == 1) {
+            this->push_down(current_from(this->parents()));
+        } else {
+            recompute(std::make_index_sequence<sizeof...(Parents)>{});
+        }
+    }
+
+private:
+    /*!
+     * Copies only the values of the parents that changed since the last
+     * recomputation, instead of building and comparing a whole new tuple.
+     * The version of the parents is checked first, and the values are only
+     * compared for those whose version changed.
+     */
+    template <std::size_t... Indices>
+    void recompute(std::index_sequence<Indices...>)
+    {
+        auto& parents = this->parents();
+        auto changed  = false;
+        noop((recompute_element<Indices>(*std::get<Indices>(parents), changed),
+              0)...);
+        if (changed) {
+            this->needs_send_down_ = true;
+            ++this->version_;
+        }
+    }
+
+    template <std::size_t Index, typename Parent>
+    void recompute_element(const Parent& parent, bool& changed)
+    {
+        if (this->parent_changed(Index)) {
+            auto& current = std::get<Index>(this->current_);
+            if (has_changed(parent.current(), current)) {
+                current = parent.current();
+                changed = true;
+            }
+        }
+    }
 };
 
 template <typename Parents>
@@ -64,8 +110,17 @@ public:
     using value_type = typename base_t::value_type;
     using base_t::base_t;
 
-    void send_up(const value_type& value) final { this->push_up(value); }
-    void send_up(value_type&& value) final { this->push_up(std::move(value)); }
+    void send_up(const value_type& value) final
+    {
+        write_barrier(this->depth());
+        this->push_up(value);
+    }
+
+    void send_up(value_type&& value) final
+    {
+        write_barrier(this->depth());
+        this->push_up(std::move(value));
+    }
 };
 
 /*!
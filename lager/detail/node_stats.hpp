@@ -0,0 +1,80 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+/*!
+ * @file
+ *
+ * Instrumentation of the node graph, only available when compiling with
+ * `LAGER_ENABLE_NODE_STATS`.  Otherwise, the nodes have no instrumentation at
+ * all.
+ *
+ * @see `lager/debug/node_graph.hpp` for inspecting the collected data.
+ */
+
+#ifdef LAGER_ENABLE_NODE_STATS
+/*!
+ * Declares the kind of node, as shown when inspecting the node graph.  To be
+ * used in the body of node classes.
+ */
+#define LAGER_DETAIL_NODE_KIND(name_)                                          \
+    const char* node_kind() const override { return name_; }
+#else
+#define LAGER_DETAIL_NODE_KIND(name_)
+#endif
+
+namespace lager {
+namespace detail {
+
+/*!
+ * Counters that a node keeps about its recomputations.  `changes` counts the
+ * times that the node propagated a new value to its children, which happens at
+ * most once per recomputation.
+ */
+struct node_stats
+{
+    std::size_t recomputes = 0;
+    std::size_t changes    = 0;
+    std::chrono::nanoseconds recompute_time{};
+};
+
+/*!
+ * Measures a recomputation of a node for as long as it is alive.
+ */
+class node_stats_scope
+{
+    using clock_t = std::chrono::steady_clock;
+
+    node_stats& stats_;
+    clock_t::time_point start_ = clock_t::now();
+
+public:
+    node_stats_scope(node_stats& stats)
+        : stats_{stats}
+    {}
+
+    node_stats_scope(const node_stats_scope&) = delete;
+    node_stats_scope& operator=(const node_stats_scope&) = delete;
+
+    ~node_stats_scope()
+    {
+        stats_.recompute_time += clock_t::now() - start_;
+        stats_.recomputes += 1;
+    }
+};
+
+} // namespace detail
+} // namespace lager
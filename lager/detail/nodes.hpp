@@ -38,6 +38,7 @@
 
 #pragma once
 
+#include <lager/detail/node_stats.hpp>
 #include <lager/detail/signal.hpp>
 #include <lager/util.hpp>
 
@@ -45,10 +46,17 @@
 #include <zug/tuplify.hpp>
 
 #include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <vector>
 
+#ifdef LAGER_ENABLE_NODE_STATS
+#include <typeinfo>
+#endif
+
 namespace lager {
 namespace detail {
 
@@ -81,6 +89,18 @@ struct reader_node_base
     virtual ~reader_node_base() = default;
     virtual void send_down()    = 0;
     virtual void notify()       = 0;
+
+#ifdef LAGER_ENABLE_NODE_STATS
+    /*!
+     * Introspection of the node graph.  @see `lager/debug/node_graph.hpp`
+     */
+    virtual const char* node_kind() const { return "node"; }
+    virtual const std::type_info& node_value_type() const = 0;
+    virtual node_stats stats() const                      = 0;
+    virtual std::size_t observer_count() const            = 0;
+    virtual std::vector<std::shared_ptr<reader_node_base>>
+    child_nodes() const = 0;
+#endif
 };
 
 /*!
@@ -101,17 +121,26 @@ struct writer_node_base
 };
 
 template <typename T, typename U>
-auto has_changed(T&& a, U&& b) -> decltype(!(a == b))
+auto has_changed_impl(const T& a, const U& b, int) -> decltype(!(a == b))
 {
     return !(a == b);
 }
 
-template <typename T>
-auto has_changed(const T&, const T&)
+template <typename T, typename U>
+bool has_changed_impl(const T&, const U&, long)
 {
     return true;
 }
 
+/*!
+ * Values that can not be compared are assumed to always change.
+ */
+template <typename T, typename U>
+bool has_changed(const T& a, const U& b)
+{
+    return has_changed_impl(a, b, 0);
+}
+
 struct notifying_guard_t
 {
     notifying_guard_t(bool& target)
@@ -139,9 +168,20 @@ public:
 
     virtual void refresh() = 0;
 
+    /*!
+     * Stamp that increases every time that `current()` changes, allowing
+     * children to know whether the value changed without comparing it.
+     */
+    virtual std::size_t version() const = 0;
+
     const value_type& current() const { return *current_view_; }
     const value_type& last() const { return *last_view_; }
 
+    /*!
+     * Length of the longest path from the node to a root node.
+     */
+    std::size_t depth() const { return depth_; }
+
     void link(std::weak_ptr<reader_node_base> child)
     {
         using namespace std;
@@ -154,6 +194,21 @@ public:
     }
     auto observers() -> signal_type& { return observers_; }
 
+#ifdef LAGER_ENABLE_NODE_STATS
+    const std::type_info& node_value_type() const final { return typeid(T); }
+
+    std::size_t observer_count() const final { return observers_.size(); }
+
+    std::vector<std::shared_ptr<reader_node_base>> child_nodes() const final
+    {
+        auto result = std::vector<std::shared_ptr<reader_node_base>>{};
+        for (auto& wchild : children_)
+            if (auto child = wchild.lock())
+                result.push_back(std::move(child));
+        return result;
+    }
+#endif
+
 protected:
     observable_reader_node(const T* current, const T* last)
         : current_view_(current)
@@ -175,6 +230,8 @@ protected:
         return children_;
     }
 
+    std::size_t depth_ = 0;
+
 private:
     const T* current_view_;
     const T* last_view_;
@@ -207,14 +264,19 @@ public:
         if (has_changed(value, current_)) {
             current_         = std::forward<U>(value);
             needs_send_down_ = true;
+            ++version_;
         }
     }
 
+    std::size_t version() const final { return version_; }
+
     void send_down() final
     {
-        this->recompute();
+        this->measured_recompute();
         if (needs_send_down_) {
-            last_            = current_;
+#ifdef LAGER_ENABLE_NODE_STATS
+            stats_.changes += 1;
+#endif
             needs_send_down_ = false;
             needs_notify_    = true;
             
@@ -230,6 +292,9 @@ public:
                     because iterators would be invalidated leading to UB. \
                     Maybe you created a new cursor inside a cursor.map(...) \
                     call?");
+            // Updated after the children, so they can compare the old and new
+            // values (@see `projection_reader_node`).
+            last_ = current_;
         }
     }
 
@@ -262,13 +327,39 @@ public:
         }
     }
 
+#ifdef LAGER_ENABLE_NODE_STATS
+    node_stats stats() const final { return stats_; }
+#endif
+
 protected:
+    /*!
+     * Whether the values of the parents changed since the last call, so the
+     * node needs to be recomputed.  Nodes without parents are always
+     * recomputed.
+     */
+    virtual bool parents_changed() { return true; }
+
+    void measured_recompute()
+    {
+        if (!this->parents_changed())
+            return;
+#ifdef LAGER_ENABLE_NODE_STATS
+        auto scope = node_stats_scope{stats_};
+#endif
+        this->recompute();
+    }
+
     value_type current_;
     value_type last_;
 
+    std::size_t version_  = 0;
     bool needs_send_down_ = false;
     bool needs_notify_    = false;
     bool notifying_       = false;
+
+#ifdef LAGER_ENABLE_NODE_STATS
+    node_stats stats_;
+#endif
 };
 
 /*!
@@ -293,17 +384,35 @@ class inner_node<ValueT, zug::meta::pack<Parents...>, Base>
 {
     using base_t = Base<ValueT>;
 
+    using versions_t = std::array<std::size_t, sizeof...(Parents)>;
+
     std::tuple<std::shared_ptr<Parents>...> parents_;
+    versions_t parent_versions_;
+    std::bitset<sizeof...(Parents)> changed_parents_;
     bool initially_defaulted_ = false;
 
+    versions_t current_parent_versions() const
+    {
+        return std::apply(
+            [](auto&&... ps) { return versions_t{ps->version()...}; },
+            parents_);
+    }
+
 public:
     inner_node(ValueT init,
                std::tuple<std::shared_ptr<Parents>...>&& parents,
                bool initially_defaulted = false)
         : base_t{std::move(init)}
         , parents_{std::move(parents)}
+        , parent_versions_{current_parent_versions()}
         , initially_defaulted_{initially_defaulted}
-    {}
+    {
+        this->depth_ = std::apply(
+            [](auto&&... ps) {
+                return std::max({std::size_t{}, ps->depth()...}) + 1;
+            },
+            parents_);
+    }
 
     template <typename U>
     void push_down(U&& value)
@@ -315,15 +424,21 @@ public:
         if (has_changed(value, this->current_) || initially_defaulted_) {
             this->current_         = std::forward<U>(value);
             this->needs_send_down_ = true;
-            initially_defaulted_  = false;
+            initially_defaulted_   = false;
+            ++this->version_;
         }
     }
 
+    /*!
+     * Brings the node up to date with the current values of the root nodes.
+     * Ancestors whose parents did not change since they were last computed
+     * are not recomputed.
+     */
     void refresh() final
     {
         std::apply([&](auto&&... ps) { noop((ps->refresh(), 0)...); },
                    parents_);
-        this->recompute();
+        this->measured_recompute();
     }
 
     const std::tuple<std::shared_ptr<Parents>...>& parents() const
@@ -338,6 +453,29 @@ public:
                 std::make_index_sequence<sizeof...(Parents)>{});
     }
 
+protected:
+    bool parents_changed() final
+    {
+        if constexpr (sizeof...(Parents) == 0)
+            return true;
+        auto versions = current_parent_versions();
+        if (versions == parent_versions_)
+            return false;
+        for (auto i = std::size_t{}; i < versions.size(); ++i)
+            changed_parents_[i] = versions[i] != parent_versions_[i];
+        parent_versions_ = versions;
+        return true;
+    }
+
+    /*!
+     * Whether the version of the parent at `index` changed before the current
+     * recomputation.  Only meaningful from within `recompute()`.
+     */
+    bool parent_changed(std::size_t index) const
+    {
+        return changed_parents_[index];
+    }
+
 private:
     template <typename T, std::size_t... Indices>
     void push_up(T&& value, std::index_sequence<Indices...>)
@@ -0,0 +1,179 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/nodes.hpp>
+
+#include <zug/meta/value_type.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace lager {
+
+namespace detail {
+
+/*!
+ * Projects the `member` of a value.
+ */
+template <typename Member>
+struct member_projection
+{
+    Member member;
+
+    template <typename T>
+    const auto& operator()(const T& x) const
+    {
+        return x.*member;
+    }
+};
+
+/*!
+ * Projects the `Index`-th element of a tuple, pair or array.
+ */
+template <std::size_t Index>
+struct element_projection
+{
+    template <typename T>
+    const auto& operator()(const T& x) const
+    {
+        return std::get<Index>(x);
+    }
+};
+
+template <typename Proj, typename Parent>
+using projection_value_t = std::decay_t<decltype(std::declval<const Proj&>()(
+    std::declval<const zug::meta::value_t<Parent>&>()))>;
+
+/*!
+ * A node that views a part of the value of its parent without copying it.
+ * Its `current()` and `last()` refer to the storage of the parent, which is
+ * valid because `Proj` must return a reference to a subobject of its
+ * argument, whose address does not change when the parent is assigned a new
+ * value.
+ *
+ * Changes are detected comparing the part in the `current()` and `last()`
+ * values of the parent, which is possible because a `reader_node` updates
+ * its `last()` value only after sending it down to its children.
+ */
+template <typename Proj, typename Parent>
+class projection_reader_node
+    : public observable_reader_node<projection_value_t<Proj, Parent>>
+{
+    using base_t = observable_reader_node<projection_value_t<Proj, Parent>>;
+
+    std::tuple<std::shared_ptr<Parent>> parents_;
+    Proj proj_;
+
+    bool needs_notify_ = false;
+    bool notifying_    = false;
+
+#ifdef LAGER_ENABLE_NODE_STATS
+    node_stats stats_;
+#endif
+
+public:
+    using value_type = typename base_t::value_type;
+
+    projection_reader_node(Proj proj, std::shared_ptr<Parent> parent)
+        : base_t{&proj(parent->current()), &proj(parent->last())}
+        , parents_{std::move(parent)}
+        , proj_{std::move(proj)}
+    {
+        this->depth_ = std::get<0>(parents_)->depth() + 1;
+    }
+
+    LAGER_DETAIL_NODE_KIND("projection")
+
+    const std::tuple<std::shared_ptr<Parent>>& parents() const
+    {
+        return parents_;
+    }
+
+    void refresh() final { std::get<0>(parents_)->refresh(); }
+
+    std::size_t version() const final
+    {
+        return std::get<0>(parents_)->version();
+    }
+
+    void send_down() final
+    {
+        auto& parent = *std::get<0>(parents_);
+        auto changed = [&] {
+#ifdef LAGER_ENABLE_NODE_STATS
+            auto scope = node_stats_scope{stats_};
+#endif
+            return has_changed(proj_(parent.current()), proj_(parent.last()));
+        }();
+        if (changed) {
+#ifdef LAGER_ENABLE_NODE_STATS
+            stats_.changes += 1;
+#endif
+            needs_notify_ = true;
+
+            const auto& children    = this->children();
+            const size_t n_children = children.size();
+            for (auto& wchild : children) {
+                if (auto child = wchild.lock()) {
+                    child->send_down();
+                }
+            }
+            assert(n_children == children.size() &&
+                   "Children must not change during send_down");
+        }
+    }
+
+    void notify() final
+    {
+        if (needs_notify_) {
+            needs_notify_ = false;
+
+            notifying_guard_t notifying_guard(notifying_);
+            bool garbage = false;
+
+            this->observers()(this->last());
+            const auto& children = this->children();
+            for (size_t i = 0, size = children.size(); i < size; ++i) {
+                if (auto child = children[i].lock()) {
+                    child->notify();
+                } else {
+                    garbage = true;
+                }
+            }
+
+            if (garbage && !notifying_guard.value_) {
+                this->collect();
+            }
+        }
+    }
+
+#ifdef LAGER_ENABLE_NODE_STATS
+    node_stats stats() const final { return stats_; }
+#endif
+};
+
+template <typename Proj, typename Parent>
+auto make_projection_reader_node(Proj proj, std::shared_ptr<Parent> parent)
+{
+    return link_to_parents(
+        std::make_shared<projection_reader_node<Proj, Parent>>(
+            std::move(proj), std::move(parent)));
+}
+
+} // namespace detail
+
+} // namespace lager
@@ -14,6 +14,7 @@
 
 #include <boost/intrusive/list.hpp>
 
+#include <cstddef>
 #include <memory>
 
 namespace lager {
@@ -79,6 +80,9 @@ public:
 
     bool empty() const { return slots_.empty(); }
 
+    //! Linear in the number of slots.
+    std::size_t size() const { return slots_.size(); }
+
 private:
     using slot_list =
         boost::intrusive::list<slot_base,
@@ -0,0 +1,178 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace lager {
+namespace detail {
+
+/*!
+ * Interface for nodes that can defer sending their values up while a write
+ * batch is open.  @see `lager::write_batch`
+ */
+struct batched_writer_node
+{
+    virtual ~batched_writer_node() = default;
+
+    /*!
+     * Sends up the value that was written while the batch was open, together
+     * with those of the nodes in `group`.  These are the pending nodes with
+     * the same `batch_parent()`, including this one, in the order in which
+     * they were first written.
+     */
+    virtual void flush_up(const std::vector<batched_writer_node*>& group) = 0;
+
+    /*!
+     * Drops the value that was written while the batch was open, restoring
+     * the one derived from the parents.
+     */
+    virtual void discard_up() = 0;
+
+    /*!
+     * Node to which this one sends its values, when its writes can be applied
+     * together with those of its siblings, or null otherwise.  Nodes that
+     * return the same parent must derive from the same `batched_child_node`.
+     */
+    virtual const void* batch_parent() const { return nullptr; }
+
+    bool write_pending = false;
+};
+
+/*!
+ * Node whose writes can be applied to a value of its parent, of type `T`, so
+ * sibling nodes can send up their writes with a single update of the parent.
+ */
+template <typename T>
+struct batched_child_node : batched_writer_node
+{
+    virtual void write_into(T& whole) const = 0;
+};
+
+/*!
+ * Nodes with pending writes of the write batch that is open in the current
+ * thread.  They are flushed deepest first, so the writes to the children of
+ * a node are all applied to its value before it is itself sent up.  Siblings
+ * are flushed together, so their parent is updated only once.
+ */
+class write_batch_state
+{
+    struct entry
+    {
+        std::size_t depth;
+        const void* parent;
+        std::size_t order;
+        std::shared_ptr<batched_writer_node> node;
+
+        // Ordered such that the top of the heap is the deepest node, and the
+        // siblings follow each other in the order in which they were written.
+        bool operator<(const entry& other) const
+        {
+            if (depth != other.depth)
+                return depth < other.depth;
+            if (parent != other.parent)
+                return std::less<const void*>{}(parent, other.parent);
+            return order > other.order;
+        }
+    };
+
+    std::vector<entry> pending_;
+    std::size_t order_ = 0;
+    bool flushing_     = false;
+
+public:
+    static write_batch_state*& current()
+    {
+        thread_local write_batch_state* state = nullptr;
+        return state;
+    }
+
+    void add(std::size_t depth, std::shared_ptr<batched_writer_node> node)
+    {
+        if (!node->write_pending) {
+            node->write_pending = true;
+            auto parent         = node->batch_parent();
+            pending_.push_back({depth, parent, order_++, std::move(node)});
+            std::push_heap(pending_.begin(), pending_.end());
+        }
+    }
+
+    /*!
+     * Sends up the pending writes of nodes at `min_depth` or deeper.  It does
+     * nothing when called while flushing, since the nodes that are sent up
+     * are then added to the batch in turn.
+     */
+    void flush(std::size_t min_depth = 0)
+    {
+        if (flushing_)
+            return;
+        struct flushing_guard
+        {
+            bool& flag;
+            ~flushing_guard() { flag = false; }
+        };
+        flushing_  = true;
+        auto guard = flushing_guard{flushing_};
+        while (!pending_.empty() && pending_.front().depth >= min_depth) {
+            auto nodes  = std::vector<std::shared_ptr<batched_writer_node>>{};
+            auto depth  = pending_.front().depth;
+            auto parent = pending_.front().parent;
+            do {
+                std::pop_heap(pending_.begin(), pending_.end());
+                nodes.push_back(std::move(pending_.back().node));
+                pending_.pop_back();
+            } while (parent && !pending_.empty() &&
+                     pending_.front().depth == depth &&
+                     pending_.front().parent == parent);
+            auto group = std::vector<batched_writer_node*>{};
+            for (auto& node : nodes) {
+                node->write_pending = false;
+                group.push_back(node.get());
+            }
+            nodes.front()->flush_up(group);
+        }
+    }
+
+    /*!
+     * Drops the pending writes.  Nodes are restored shallowest first, so the
+     * values that they derive from their parents do not contain the writes
+     * either.
+     */
+    void discard()
+    {
+        std::sort_heap(pending_.begin(), pending_.end());
+        for (auto& e : pending_) {
+            e.node->write_pending = false;
+            e.node->discard_up();
+        }
+        pending_.clear();
+    }
+};
+
+/*!
+ * To be called before a node at `depth` sends a value up, so the pending
+ * writes to nodes that may be its descendants, which happened before, are
+ * not applied after it.
+ */
+inline void write_barrier(std::size_t depth)
+{
+    if (auto batch = write_batch_state::current())
+        batch->flush(depth + 1);
+}
+
+} // namespace detail
+} // namespace lager
@@ -15,6 +15,7 @@
 #include <lager/config.hpp>
 #include <lager/detail/no_value.hpp>
 #include <lager/detail/nodes.hpp>
+#include <lager/detail/write_batch.hpp>
 #include <lager/util.hpp>
 
 #include <zug/meta.hpp>
@@ -23,8 +24,9 @@
 #include <zug/tuplify.hpp>
 #include <zug/util.hpp>
 
-#include <zug/reducing/last.hpp>
-
+#include <optional>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace lager {
@@ -46,32 +48,54 @@ ZUG_INLINE_CONSTEXPR struct send_down_rf_t
     }
 } send_down_rf{};
 
-template<typename ValueT>
+template <typename ValueT>
 struct initial_value
 {
     ValueT value;
     bool defaulted;
 };
 
-template <typename ValueT, typename Xform, typename... ParentPtrs>
-initial_value<ValueT> get_initial_value(Xform&& xform, const std::tuple<ParentPtrs...>& parents)
+/*!
+ * Reducing function that stores the last received value in the optional
+ * that is passed as pointer as an accumulator.  Unlike `zug::last`, it
+ * allows telling whether the transducer produced any value without throwing.
+ */
+template <typename ValueT>
+struct probe_rf_t
 {
-    LAGER_TRY {
-        return {std::apply(
-                    [&](auto&&... ps) {
-                        return xform(zug::last)(detail::no_value{}, ps->current()...);
-                    },
-                    parents),
-                false};
-    } LAGER_CATCH(const no_value_error&) {
-        if constexpr (std::is_default_constructible<ValueT>::value) {
-            return {ValueT{}, true};
-        } else {
-            LAGER_THROW();
-        }
+    template <typename... Inputs>
+    auto operator()(std::optional<ValueT>* s, Inputs&&... is) const
+        -> std::optional<ValueT>*
+    {
+        s->emplace(zug::tuplify(std::forward<Inputs>(is)...));
+        return s;
+    }
+
+    auto operator()(std::optional<ValueT>* s) const -> std::optional<ValueT>*
+    {
+        return s;
     }
 };
 
+template <typename ValueT, typename Xform, typename... ParentPtrs>
+initial_value<ValueT> get_initial_value(Xform&& xform,
+                                        const std::tuple<ParentPtrs...>& parents)
+{
+    auto result = std::optional<ValueT>{};
+    std::apply(
+        [&](auto&&... ps) {
+            xform(probe_rf_t<ValueT>{})(&result, ps->current()...);
+        },
+        parents);
+    if (result) {
+        return {std::move(*result), false};
+    } else if constexpr (std::is_default_constructible<ValueT>::value) {
+        return {ValueT{}, true};
+    } else {
+        LAGER_THROW(no_value_error{});
+    }
+}
+
 /*!
  * Implementation of a node with a transducer.
  */
@@ -116,6 +140,7 @@ private:
     {}
 
 public:
+    LAGER_DETAIL_NODE_KIND("xform")
 
     void recompute() final
     {
@@ -159,8 +184,17 @@ public:
         , up_step_{wxform(send_up_rf)}
     {}
 
-    void send_up(const value_type& value) final { up_step_(this, value); }
-    void send_up(value_type&& value) final { up_step_(this, std::move(value)); }
+    void send_up(const value_type& value) final
+    {
+        write_barrier(this->depth());
+        up_step_(this, value);
+    }
+
+    void send_up(value_type&& value) final
+    {
+        write_barrier(this->depth());
+        up_step_(this, std::move(value));
+    }
 };
 
 /*!
@@ -16,27 +16,136 @@
 
 #include <QtConcurrent/QtConcurrent>
 #include <QtCore/QCoreApplication>
-#include <QtCore/QEvent>
 #include <QtCore/QObject>
 #include <QtCore/QThreadPool>
 
 #include <functional>
-#include <stdexcept>
+#include <memory>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 namespace lager {
 
-struct with_qt_event_loop
+namespace detail {
+
+/*!
+ * Queue of closures posted to a `with_qt_event_loop`.  Only one Qt event is in
+ * flight at a time: it is posted when the queue goes from empty to non-empty,
+ * and evaluates all the queued closures in one go.
+ *
+ * It is shared by all the copies of the event loop.  When the last one goes
+ * away, the pending closures are discarded and the asynchronous work is
+ * waited for.  The event that is still in flight then does nothing, but it is
+ * not removed, since the object may be shared with other queues.
+ */
+class qt_post_queue : public std::enable_shared_from_this<qt_post_queue>
 {
-    std::reference_wrapper<QObject> obj;
-    std::reference_wrapper<QThreadPool> thread_pool =
-        *QThreadPool::globalInstance();
+    using event_fn = std::function<void()>;
+
+    QObject& obj_;
+    QThreadPool& thread_pool_;
+    std::mutex mutex_;
+    std::vector<event_fn> queue_;
+    bool scheduled_ = false;
+    bool paused_    = false;
+
+public:
+    qt_post_queue(QObject& obj, QThreadPool& thread_pool)
+        : obj_{obj}
+        , thread_pool_{thread_pool}
+    {}
+
+    ~qt_post_queue() { thread_pool_.waitForDone(); }
+
+    template <typename Fn>
+    void post(Fn&& fn)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        queue_.emplace_back(std::forward<Fn>(fn));
+        schedule_(lock);
+    }
+
+    void pause()
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        paused_ = true;
+    }
+
+    void resume()
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        paused_ = false;
+        schedule_(lock);
+    }
+
+    // If there is an exception, the remaining closures are put back into the
+    // queue and evaluated in the next event.
+    void drain()
+    {
+        auto running = std::vector<event_fn>{};
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            scheduled_ = false;
+            if (paused_)
+                return;
+            std::swap(running, queue_);
+        }
+        for (auto i = std::size_t{}; i < running.size();) {
+            try {
+                auto fn = std::move(running[i++]);
+                std::move(fn)();
+            } catch (...) {
+                std::unique_lock<std::mutex> lock{mutex_};
+                queue_.insert(queue_.begin(),
+                              std::make_move_iterator(running.begin() + i),
+                              std::make_move_iterator(running.end()));
+                schedule_(lock);
+                throw;
+            }
+        }
+    }
 
-    ~with_qt_event_loop()
+private:
+    void schedule_(std::unique_lock<std::mutex>& lock)
     {
-        QCoreApplication::removePostedEvents(&obj.get(), QEvent::MetaCall);
-        thread_pool.get().waitForDone();
+        if (scheduled_ || paused_ || queue_.empty())
+            return;
+        scheduled_ = true;
+        lock.unlock();
+        QMetaObject::invokeMethod(
+            &obj_,
+            [self = weak_from_this()] {
+                if (auto q = self.lock())
+                    q->drain();
+            },
+            Qt::QueuedConnection);
     }
+};
+
+} // namespace detail
+
+/*!
+ * Event loop that relies on the Qt event loop of the thread of the given
+ * `QObject`.  Posted closures are coalesced: at most one Qt event is pending
+ * at a time and it evaluates all the closures posted until then.  Asynchronous
+ * work is run in a `QThreadPool`, the global one by default.
+ *
+ * Copies share their queue of closures.  Once the last copy is destroyed or
+ * assigned another loop, the closures that are still pending are discarded
+ * and it waits for the asynchronous work to finish.
+ */
+struct with_qt_event_loop
+{
+    std::reference_wrapper<QObject> obj;
+    std::reference_wrapper<QThreadPool> thread_pool;
+
+    with_qt_event_loop(QObject& obj_,
+                       QThreadPool& pool = *QThreadPool::globalInstance())
+        : obj{obj_}
+        , thread_pool{pool}
+        , queue_{std::make_shared<detail::qt_post_queue>(obj_, pool)}
+    {}
 
     template <typename Fn>
     void async(Fn&& fn)
@@ -47,14 +156,16 @@ struct with_qt_event_loop
     template <typename Fn>
     void post(Fn&& fn)
     {
-        QMetaObject::invokeMethod(
-            &obj.get(), std::forward<Fn>(fn), Qt::QueuedConnection);
+        queue_->post(std::forward<Fn>(fn));
     }
 
     void finish() { QCoreApplication::instance()->quit(); }
 
-    void pause() { LAGER_THROW(std::runtime_error{"not implemented!"}); }
-    void resume() { LAGER_THROW(std::runtime_error{"not implemented!"}); }
+    void pause() { queue_->pause(); }
+    void resume() { queue_->resume(); }
+
+private:
+    std::shared_ptr<detail::qt_post_queue> queue_;
 };
 
 } // namespace lager
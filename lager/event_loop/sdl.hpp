@@ -13,6 +13,7 @@
 #pragma once
 
 #include <lager/config.hpp>
+#include <lager/detail/frame_scheduler.hpp>
 
 #include <SDL2/SDL.h>
 
@@ -71,12 +72,134 @@ struct constant_fps_step
     }
 };
 
+/*!
+ * Milliseconds elapsed since `start`, a value of `SDL_GetPerformanceCounter()`.
+ */
+inline float sdl_elapsed_ms(std::uint64_t start)
+{
+    auto delta = SDL_GetPerformanceCounter() - start;
+    return static_cast<float>(delta * 1000.0 / SDL_GetPerformanceFrequency());
+}
+
+/*!
+ * Lock-free multiple-producer single-consumer queue for the closures posted to
+ * the `sdl_event_loop`.  Producers push with a single CAS on the head of an
+ * intrusive stack.  The consumer takes the whole stack at once and reverses it,
+ * so closures run in the order in which they were posted.
+ */
+class sdl_post_queue
+{
+    struct node
+    {
+        std::function<void()> fn;
+        node* next;
+    };
+
+    std::atomic<node*> head_{nullptr};
+    node* batch_ = nullptr;
+
+    static void delete_list(node* n)
+    {
+        while (n) {
+            auto next = n->next;
+            delete n;
+            n = next;
+        }
+    }
+
+public:
+    sdl_post_queue() = default;
+    sdl_post_queue(const sdl_post_queue&) = delete;
+    sdl_post_queue& operator=(const sdl_post_queue&) = delete;
+
+    ~sdl_post_queue()
+    {
+        delete_list(batch_);
+        delete_list(head_.exchange(nullptr));
+    }
+
+    /*!
+     * Thread-safe, may be called from any thread.
+     */
+    void push(std::function<void()> fn)
+    {
+        auto n = new node{std::move(fn), head_.load(std::memory_order_relaxed)};
+        while (!head_.compare_exchange_weak(n->next,
+                                            n,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {}
+    }
+
+    /*!
+     * Runs the pending closures, including those posted while running them,
+     * until the queue is empty or `budget_ms` milliseconds have elapsed, in
+     * which case the remaining ones are kept for the next call.  At least one
+     * closure is run when there is some pending.  Returns whether there is
+     * still pending work.  Must only be called from the thread running the
+     * event loop.
+     */
+    bool drain(float budget_ms)
+    {
+        auto start = SDL_GetPerformanceCounter();
+        while (true) {
+            if (!batch_ && !(batch_ = take_all_()))
+                return false;
+            auto n = std::unique_ptr<node>{batch_};
+            batch_ = n->next;
+            n->fn();
+            if (sdl_elapsed_ms(start) >= budget_ms)
+                return batch_ || head_.load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    node* take_all_()
+    {
+        auto n    = head_.exchange(nullptr, std::memory_order_acquire);
+        auto prev = static_cast<node*>(nullptr);
+        while (n) {
+            auto next = n->next;
+            n->next   = prev;
+            prev      = n;
+            n         = next;
+        }
+        return prev;
+    }
+};
+
 } // namespace detail
 
+/*!
+ * Frame time statistics collected by `sdl_event_loop` when running with a
+ * `tick` function.
+ */
+using sdl_frame_stats = frame_stats;
+
+/*!
+ * Event loop for applications based on SDL.
+ *
+ * Posted closures are not sent through the SDL event queue one by one.  They
+ * are stored in an internal lock-free queue and the SDL event queue receives at
+ * most one pending *wake* event.  The `run()` loops then evaluate the posted
+ * closures in time-bounded batches, deferring the rest to the next iteration.
+ *
+ * When running with a `tick` function, the time spent handling events and
+ * posted closures (where reducers, effects and watchers are evaluated) is
+ * bounded by a per frame budget, half of the frame time by default, so that
+ * rendering at the target frame rate is not starved by bursts of dispatched
+ * actions.  Posted closures get what is left of the budget after the events,
+ * and at least one of them is evaluated per frame.  Use
+ * `set_frame_budget()` to change it and `frame_stats()` to inspect how the
+ * frames are doing.
+ */
 struct sdl_event_loop
 {
     using event_fn = std::function<void()>;
 
+    //! Milliseconds spent evaluating posted closures per batch when there is
+    //! no frame rate to derive it from.
+    static constexpr float default_post_budget = 8.f;
+
 #if __EMSCRIPTEN__
     std::function<bool(const SDL_Event&)> current_handler;
     std::function<void(float)> current_tick;
@@ -87,14 +210,10 @@ struct sdl_event_loop
         auto event = SDL_Event{};
         last_ticks = SDL_GetTicks();
         while (SDL_PollEvent(&event)) {
-            if (event.type == post_event_type_) {
-                auto fnp = static_cast<event_fn*>(event.user.data1);
-                (*fnp)();
-                delete fnp;
-            } else {
+            if (event.type != post_event_type_)
                 current_handler(event);
-            }
         }
+        drain_posts_(default_post_budget);
         auto ticks = SDL_GetTicks();
         auto dt    = static_cast<float>(ticks - last_ticks);
         current_tick(dt);
@@ -128,9 +247,7 @@ struct sdl_event_loop
             auto event = SDL_Event{};
             if (SDL_WaitEvent(&event)) {
                 if (event.type == post_event_type_) {
-                    auto fnp = static_cast<event_fn*>(event.user.data1);
-                    (*fnp)();
-                    delete fnp;
+                    drain_posts_(default_post_budget);
                 } else {
                     continue_ = handler(event);
                 }
@@ -143,54 +260,96 @@ struct sdl_event_loop
     {
         auto continue_ = true;
         auto step      = detail::constant_fps_step{fps, min_sim_fps};
+        auto drain     = [this](float budget) { return drain_posts_(budget); };
+        scheduler_.start(step.ticks_per_frame_);
         while (continue_ && !done_) {
             auto event = SDL_Event{};
+            scheduler_.begin_frame();
             while (continue_ && ((!paused_ && SDL_PollEvent(&event)) ||
                                  (paused_ && SDL_WaitEvent(&event)))) {
-                if (event.type == post_event_type_) {
-                    auto fnp = std::unique_ptr<event_fn>{
-                        static_cast<event_fn*>(event.user.data1)};
-                    (*fnp)();
-                } else {
-                    continue_ = continue_ && (paused_ || handler(event));
+                if (paused_) {
+                    // time spent waiting while paused is not frame work
+                    if (event.type == post_event_type_)
+                        drain_posts_(default_post_budget);
+                    scheduler_.begin_frame();
+                } else if (event.type != post_event_type_) {
+                    continue_ = continue_ && handler(event);
                 }
             }
-            continue_ = continue_ && (paused_ || tick(step()));
+            scheduler_.run_posts(drain);
+            if (!paused_) {
+                continue_ = continue_ && tick(scheduler_.idle(step));
+                scheduler_.end_frame();
+            }
         }
     }
 #endif // !__EMSCRIPTEN__
 
     void post(event_fn ev)
     {
+        posts_.push(std::move(ev));
+        wake_();
+    }
+
+    void finish() { done_ = true; }
+    void pause() { paused_ = true; }
+    void resume() { paused_ = false; }
+
+    /*!
+     * Sets the time, in milliseconds, that can be spent handling events and
+     * evaluating posted closures per frame when running with a `tick`
+     * function.  The closures that do not fit are deferred to the next frame.
+     * Zero restores the default, half of the frame time.
+     */
+    void set_frame_budget(float ms) { scheduler_.set_budget(ms); }
+
+    /*!
+     * Returns the statistics of the frames run so far.  Must be called from
+     * the thread running the event loop.
+     */
+    sdl_frame_stats frame_stats() const { return scheduler_.stats(); }
+
+private:
+    friend with_sdl_event_loop;
+
+    void wake_()
+    {
+        if (wake_pending_.exchange(true))
+            return;
 #if !__EMSCRIPTEN__
         auto event = SDL_Event{};
         SDL_zero(event);
-        event.type       = post_event_type_;
-        event.user.data1 = new event_fn{std::move(ev)};
+        event.type = post_event_type_;
         SDL_PushEvent(&event);
 #else
         ::emscripten_set_timeout(
-            [](void* data) {
-                auto fn =
-                    std::unique_ptr<event_fn>{static_cast<event_fn*>(data)};
-                (*fn)();
+            [](void* loop_) {
+                auto loop = static_cast<sdl_event_loop*>(loop_);
+                loop->drain_posts_(default_post_budget);
             },
             0,
-            new event_fn{std::move(ev)});
+            this);
 #endif
     }
 
-    void finish() { done_ = true; }
-    void pause() { paused_ = true; }
-    void resume() { paused_ = false; }
-
-private:
-    friend with_sdl_event_loop;
+    bool drain_posts_(float budget_ms)
+    {
+        // Clear the flag before taking the queue, so that closures that are
+        // posted concurrently or from within the batch get a new wake event.
+        wake_pending_ = false;
+        auto pending  = posts_.drain(budget_ms);
+        if (pending)
+            wake_();
+        return pending;
+    }
 
     std::atomic<bool> done_{false};
     std::atomic<bool> paused_{false};
+    std::atomic<bool> wake_pending_{false};
+    detail::sdl_post_queue posts_;
+    detail::frame_scheduler<> scheduler_;
     std::uint32_t post_event_type_ = SDL_RegisterEvents(1);
-}; // namespace lager
+};
 
 struct with_sdl_event_loop
 {
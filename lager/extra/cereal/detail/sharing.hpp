@@ -0,0 +1,143 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/config.hpp>
+
+#include <cereal/cereal.hpp>
+#include <zug/meta/detected.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace lager {
+
+namespace detail {
+
+/*!
+ * Identifies the value of an immutable container by the addresses of the
+ * nodes that hold its data, which can not change while it is alive.
+ */
+using shared_key =
+    std::tuple<std::type_index, const void*, const void*, std::size_t>;
+
+template <typename T>
+shared_key make_shared_key(const T&,
+                           const void* a,
+                           const void* b    = nullptr,
+                           std::size_t size = 0)
+{
+    return {std::type_index{typeid(T)}, a, b, size};
+}
+
+/*!
+ * Ids of the containers saved with an output archive, and copies of them, so
+ * their nodes are not reused for other values while saving.
+ */
+struct output_sharing
+{
+    std::map<shared_key, std::uint32_t> ids;
+    std::vector<std::shared_ptr<const void>> retained;
+};
+
+/*!
+ * Containers loaded with an input archive, by id.
+ */
+struct input_sharing
+{
+    struct entry
+    {
+        std::shared_ptr<const void> value;
+        const std::type_info* type = nullptr;
+    };
+
+    std::vector<entry> values;
+};
+
+template <typename Archive>
+using archive_sharing_t = decltype(std::declval<Archive&>().sharing());
+
+/*!
+ * Whether an archive preserves the sharing of the containers saved with it,
+ * which it tells by having a `sharing()` method returning an
+ * `output_sharing&` or `input_sharing&`.  It is known at compile time, so
+ * other archives do not pay for it.
+ */
+template <typename Archive>
+constexpr bool preserves_sharing =
+    zug::meta::is_detected<archive_sharing_t, Archive>::value;
+
+/*!
+ * Saves `x` calling `save_fn`.  When the archive preserves sharing, this
+ * happens only the first time that a container with the same `key` is saved,
+ * and later only a reference to it is saved.
+ */
+template <typename Archive, typename T, typename Fn>
+void save_shared(Archive& ar, const T& x, const shared_key& key, Fn&& save_fn)
+{
+    if constexpr (!preserves_sharing<Archive>) {
+        std::forward<Fn>(save_fn)();
+    } else {
+        output_sharing& sharing = ar.sharing();
+        auto [it, inserted]     = sharing.ids.emplace(
+            key, static_cast<std::uint32_t>(sharing.retained.size() + 1));
+        ar(cereal::make_nvp("shared",
+                            inserted ? std::uint32_t{} : it->second));
+        if (inserted) {
+            sharing.retained.push_back(std::make_shared<const T>(x));
+            std::forward<Fn>(save_fn)();
+        }
+    }
+}
+
+/*!
+ * Loads `x` calling `load_fn`, or from a container loaded before when it was
+ * saved as a reference to it.  @see `save_shared`
+ */
+template <typename Archive, typename T, typename Fn>
+void load_shared(Archive& ar, T& x, Fn&& load_fn)
+{
+    if constexpr (!preserves_sharing<Archive>) {
+        std::forward<Fn>(load_fn)();
+    } else {
+        input_sharing& sharing = ar.sharing();
+        auto ref               = std::uint32_t{};
+        ar(cereal::make_nvp("shared", ref));
+        auto& values = sharing.values;
+        if (ref == 0) {
+            // reserve the id before loading, containers inside this one get
+            // the following ids as they did when saving
+            auto index = values.size();
+            values.emplace_back();
+            std::forward<Fn>(load_fn)();
+            values[index] = {std::make_shared<const T>(x), &typeid(T)};
+        } else if (ref <= values.size() && values[ref - 1].value &&
+                   *values[ref - 1].type == typeid(T)) {
+            x = *std::static_pointer_cast<const T>(values[ref - 1].value);
+        } else {
+            LAGER_THROW(std::runtime_error{"invalid shared reference"});
+        }
+    }
+}
+
+} // namespace detail
+
+} // namespace lager
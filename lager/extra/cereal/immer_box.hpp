@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <lager/extra/cereal/detail/sharing.hpp>
+
 #include <cereal/cereal.hpp>
 #include <immer/box.hpp>
 #include <type_traits>
@@ -21,15 +23,20 @@ namespace cereal {
 template <typename Archive, typename T, typename MP>
 void CEREAL_SAVE_FUNCTION_NAME(Archive& ar, const immer::box<T, MP>& b)
 {
-    ar(cereal::make_nvp("value", b.get()));
+    auto key = lager::detail::make_shared_key(b, &b.get());
+    lager::detail::save_shared(ar, b, key, [&] {
+        ar(cereal::make_nvp("value", b.get()));
+    });
 }
 
 template <typename Archive, typename T, typename MP>
 void CEREAL_LOAD_FUNCTION_NAME(Archive& ar, immer::box<T, MP>& b)
 {
-    T x;
-    ar(cereal::make_nvp("value", x));
-    b = x;
+    lager::detail::load_shared(ar, b, [&] {
+        T x;
+        ar(cereal::make_nvp("value", x));
+        b = x;
+    });
 }
 
 } // namespace cereal
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <lager/extra/cereal/detail/sharing.hpp>
+
 #include <cereal/cereal.hpp>
 #include <immer/flex_vector.hpp>
 #include <immer/flex_vector_transient.hpp>
@@ -31,9 +33,15 @@ template <typename Archive,
 void CEREAL_SAVE_FUNCTION_NAME(
     Archive& ar, const immer::flex_vector<T, MP, B, BL>& flex_vector)
 {
-    ar(make_size_tag(static_cast<size_type>(flex_vector.size())));
-    for (auto&& v : flex_vector)
-        ar(v);
+    auto key = lager::detail::make_shared_key(flex_vector,
+                                              flex_vector.impl().root,
+                                              flex_vector.impl().tail,
+                                              flex_vector.size());
+    lager::detail::save_shared(ar, flex_vector, key, [&] {
+        ar(make_size_tag(static_cast<size_type>(flex_vector.size())));
+        for (auto&& v : flex_vector)
+            ar(v);
+    });
 }
 
 template <typename Archive,
@@ -44,21 +52,23 @@ template <typename Archive,
 void CEREAL_LOAD_FUNCTION_NAME(Archive& ar,
                                immer::flex_vector<T, MP, B, BL>& flex_vector)
 {
-    size_type size{};
-    ar(make_size_tag(size));
+    lager::detail::load_shared(ar, flex_vector, [&] {
+        size_type size{};
+        ar(make_size_tag(size));
 
-    if (!size)
-        return;
+        if (!size)
+            return;
 
-    auto t = immer::flex_vector<T, MP, B, BL>{}.transient();
-    for (auto i = size_type{}; i < size; ++i) {
-        T x;
-        ar(x);
-        t.push_back(std::move(x));
-    }
-    flex_vector = std::move(t).persistent();
+        auto t = immer::flex_vector<T, MP, B, BL>{}.transient();
+        for (auto i = size_type{}; i < size; ++i) {
+            T x;
+            ar(x);
+            t.push_back(std::move(x));
+        }
+        flex_vector = std::move(t).persistent();
 
-    assert(size == flex_vector.size());
+        assert(size == flex_vector.size());
+    });
 }
 
 } // namespace cereal
@@ -12,11 +12,14 @@
 
 #pragma once
 
+#include <lager/extra/cereal/detail/sharing.hpp>
+
 #include <lager/config.hpp>
 
 #include <cereal/cereal.hpp>
 
 #include <immer/map.hpp>
+#include <immer/map_transient.hpp>
 
 namespace cereal {
 
@@ -45,17 +48,21 @@ template <typename Archive,
 std::enable_if_t<has_auto_id<K, T>::value>
 CEREAL_LOAD_FUNCTION_NAME(Archive& ar, immer::map<K, T, H, E, MP, B>& m)
 {
-    size_type size;
-    ar(make_size_tag(size));
-
-    for (auto i = size_type{}; i < size; ++i) {
-        T x;
-        ar(x);
-        auto id = get_auto_id(x);
-        m       = std::move(m).set(std::move(id), std::move(x));
-    }
-    if (size != m.size())
-        LAGER_THROW(std::runtime_error{"duplicate ids?"});
+    lager::detail::load_shared(ar, m, [&] {
+        size_type size;
+        ar(make_size_tag(size));
+
+        auto t = immer::map<K, T, H, E, MP, B>{}.transient();
+        for (auto i = size_type{}; i < size; ++i) {
+            T x;
+            ar(x);
+            auto id = get_auto_id(x);
+            t.set(std::move(id), std::move(x));
+        }
+        m = std::move(t).persistent();
+        if (size != m.size())
+            LAGER_THROW(std::runtime_error{"duplicate ids?"});
+    });
 }
 
 template <typename Archive,
@@ -68,9 +75,13 @@ template <typename Archive,
 std::enable_if_t<has_auto_id<K, T>::value>
 CEREAL_SAVE_FUNCTION_NAME(Archive& ar, const immer::map<K, T, H, E, MP, B>& m)
 {
-    ar(make_size_tag(static_cast<size_type>(m.size())));
-    for (auto&& v : m)
-        ar(v.second);
+    auto key =
+        lager::detail::make_shared_key(m, m.impl().root, nullptr, m.size());
+    lager::detail::save_shared(ar, m, key, [&] {
+        ar(make_size_tag(static_cast<size_type>(m.size())));
+        for (auto&& v : m)
+            ar(v.second);
+    });
 }
 
 template <typename Archive,
@@ -83,17 +94,21 @@ template <typename Archive,
 std::enable_if_t<!has_auto_id<K, T>::value>
 CEREAL_LOAD_FUNCTION_NAME(Archive& ar, immer::map<K, T, H, E, MP, B>& m)
 {
-    size_type size;
-    ar(make_size_tag(size));
-
-    for (auto i = size_type{}; i < size; ++i) {
-        K k;
-        T x;
-        ar(make_map_item(k, x));
-        m = std::move(m).set(std::move(k), std::move(x));
-    }
-    if (size != m.size())
-        LAGER_THROW(std::runtime_error{"duplicate ids?"});
+    lager::detail::load_shared(ar, m, [&] {
+        size_type size;
+        ar(make_size_tag(size));
+
+        auto t = immer::map<K, T, H, E, MP, B>{}.transient();
+        for (auto i = size_type{}; i < size; ++i) {
+            K k;
+            T x;
+            ar(make_map_item(k, x));
+            t.set(std::move(k), std::move(x));
+        }
+        m = std::move(t).persistent();
+        if (size != m.size())
+            LAGER_THROW(std::runtime_error{"duplicate ids?"});
+    });
 }
 
 template <typename Archive,
@@ -106,9 +121,13 @@ template <typename Archive,
 std::enable_if_t<!has_auto_id<K, T>::value>
 CEREAL_SAVE_FUNCTION_NAME(Archive& ar, const immer::map<K, T, H, E, MP, B>& m)
 {
-    ar(make_size_tag(static_cast<size_type>(m.size())));
-    for (auto&& v : m)
-        ar(make_map_item(v.first, v.second));
+    auto key =
+        lager::detail::make_shared_key(m, m.impl().root, nullptr, m.size());
+    lager::detail::save_shared(ar, m, key, [&] {
+        ar(make_size_tag(static_cast<size_type>(m.size())));
+        for (auto&& v : m)
+            ar(make_map_item(v.first, v.second));
+    });
 }
 
 } // namespace cereal
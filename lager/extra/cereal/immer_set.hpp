@@ -12,11 +12,14 @@
 
 #pragma once
 
+#include <lager/extra/cereal/detail/sharing.hpp>
+
 #include <lager/config.hpp>
 
 #include <cereal/cereal.hpp>
 
 #include <immer/set.hpp>
+#include <immer/set_transient.hpp>
 
 namespace cereal {
 
@@ -28,16 +31,20 @@ template <typename Archive,
           std::uint32_t B>
 void CEREAL_LOAD_FUNCTION_NAME(Archive& ar, immer::set<T, H, E, MP, B>& m)
 {
-    size_type size;
-    ar(make_size_tag(size));
-
-    for (auto i = size_type{}; i < size; ++i) {
-        T x;
-        ar(x);
-        m = std::move(m).insert(std::move(x));
-    }
-    if (size != m.size())
-        LAGER_THROW(std::runtime_error{"duplicate items?"});
+    lager::detail::load_shared(ar, m, [&] {
+        size_type size;
+        ar(make_size_tag(size));
+
+        auto t = immer::set<T, H, E, MP, B>{}.transient();
+        for (auto i = size_type{}; i < size; ++i) {
+            T x;
+            ar(x);
+            t.insert(std::move(x));
+        }
+        m = std::move(t).persistent();
+        if (size != m.size())
+            LAGER_THROW(std::runtime_error{"duplicate items?"});
+    });
 }
 
 template <typename Archive,
@@ -48,9 +55,13 @@ template <typename Archive,
           std::uint32_t B>
 void CEREAL_SAVE_FUNCTION_NAME(Archive& ar, const immer::set<T, H, E, MP, B>& m)
 {
-    ar(make_size_tag(static_cast<size_type>(m.size())));
-    for (auto&& v : m)
-        ar(v);
+    auto key =
+        lager::detail::make_shared_key(m, m.impl().root, nullptr, m.size());
+    lager::detail::save_shared(ar, m, key, [&] {
+        ar(make_size_tag(static_cast<size_type>(m.size())));
+        for (auto&& v : m)
+            ar(v);
+    });
 }
 
 } // namespace cereal
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <lager/extra/cereal/detail/sharing.hpp>
+
 #include <cereal/cereal.hpp>
 #include <immer/box.hpp>
 #include <immer/vector.hpp>
@@ -32,9 +34,13 @@ template <typename Archive,
 void CEREAL_SAVE_FUNCTION_NAME(Archive& ar,
                                const immer::vector<T, MP, B, BL>& vector)
 {
-    ar(make_size_tag(static_cast<size_type>(vector.size())));
-    for (auto&& v : vector)
-        ar(v);
+    auto key = lager::detail::make_shared_key(
+        vector, vector.impl().root, vector.impl().tail, vector.size());
+    lager::detail::save_shared(ar, vector, key, [&] {
+        ar(make_size_tag(static_cast<size_type>(vector.size())));
+        for (auto&& v : vector)
+            ar(v);
+    });
 }
 
 template <typename Archive,
@@ -44,21 +50,23 @@ template <typename Archive,
           std::uint32_t BL>
 void CEREAL_LOAD_FUNCTION_NAME(Archive& ar, immer::vector<T, MP, B, BL>& vector)
 {
-    size_type size{};
-    ar(make_size_tag(size));
+    lager::detail::load_shared(ar, vector, [&] {
+        size_type size{};
+        ar(make_size_tag(size));
 
-    if (!size)
-        return;
+        if (!size)
+            return;
 
-    auto t = immer::vector<T, MP, B, BL>{}.transient();
-    for (auto i = size_type{}; i < size; ++i) {
-        T x;
-        ar(x);
-        t.push_back(std::move(x));
-    }
-    vector = std::move(t).persistent();
+        auto t = immer::vector<T, MP, B, BL>{}.transient();
+        for (auto i = size_type{}; i < size; ++i) {
+            T x;
+            ar(x);
+            t.push_back(std::move(x));
+        }
+        vector = std::move(t).persistent();
 
-    assert(size == vector.size());
+        assert(size == vector.size());
+    });
 }
 
 template <typename Archive,
@@ -69,9 +77,13 @@ template <typename Archive,
 void CEREAL_SAVE_FUNCTION_NAME(
     Archive& ar, const immer::vector<immer::box<T, MP>, MP, B, BL>& vector)
 {
-    ar(make_size_tag(static_cast<size_type>(vector.size())));
-    for (auto&& v : vector)
-        ar(*v);
+    auto key = lager::detail::make_shared_key(
+        vector, vector.impl().root, vector.impl().tail, vector.size());
+    lager::detail::save_shared(ar, vector, key, [&] {
+        ar(make_size_tag(static_cast<size_type>(vector.size())));
+        for (auto&& v : vector)
+            ar(*v);
+    });
 }
 
 template <typename Archive,
@@ -82,21 +94,23 @@ template <typename Archive,
 void CEREAL_LOAD_FUNCTION_NAME(
     Archive& ar, immer::vector<immer::box<T, MP>, MP, B, BL>& vector)
 {
-    size_type size{};
-    ar(make_size_tag(size));
+    lager::detail::load_shared(ar, vector, [&] {
+        size_type size{};
+        ar(make_size_tag(size));
 
-    if (!size)
-        return;
+        if (!size)
+            return;
 
-    auto t = immer::vector<immer::box<T, MP>, MP, B, BL>{}.transient();
-    for (auto i = size_type{}; i < size; ++i) {
-        T x;
-        ar(x);
-        t.push_back(std::move(x));
-    }
-    vector = std::move(t).persistent();
+        auto t = immer::vector<immer::box<T, MP>, MP, B, BL>{}.transient();
+        for (auto i = size_type{}; i < size; ++i) {
+            T x;
+            ar(x);
+            t.push_back(std::move(x));
+        }
+        vector = std::move(t).persistent();
 
-    assert(size == vector.size());
+        assert(size == vector.size());
+    });
 }
 
 } // namespace cereal
@@ -0,0 +1,138 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/extra/cereal/detail/sharing.hpp>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/cereal.hpp>
+
+#include <ios>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+
+namespace lager {
+
+/*!
+ * A binary archive that saves every immer container and box only once, and
+ * references to it when it appears again.  Sharing is preserved per container
+ * and per box, not per internal node: a container that differs from a saved
+ * one in a single element is saved whole.  This still makes histories of
+ * models, like the ones kept for undo, much smaller when most of their
+ * containers are the same from one version to the next.
+ *
+ * The immer serialization functions only do this for archives that, like
+ * this one, have a `sharing()` method.  Other archives are not affected, and
+ * only the programs that include this header pay for it.  Only archives that
+ * save the values in order, like the binary ones, can preserve sharing.
+ */
+class shared_binary_output_archive
+    : public cereal::OutputArchive<shared_binary_output_archive,
+                                   cereal::AllowEmptyClassElision>
+{
+    cereal::BinaryOutputArchive binary_;
+    detail::output_sharing sharing_;
+
+public:
+    shared_binary_output_archive(std::ostream& stream)
+        : OutputArchive{this}
+        , binary_{stream}
+    {}
+
+    detail::output_sharing& sharing() { return sharing_; }
+
+    void save_binary(const void* data, std::streamsize size)
+    {
+        binary_.saveBinary(data, size);
+    }
+};
+
+/*!
+ * Loads archives saved with `shared_binary_output_archive`.  The loaded
+ * containers share the structure that they shared when they were saved.
+ */
+class shared_binary_input_archive
+    : public cereal::InputArchive<shared_binary_input_archive,
+                                  cereal::AllowEmptyClassElision>
+{
+    cereal::BinaryInputArchive binary_;
+    detail::input_sharing sharing_;
+
+public:
+    shared_binary_input_archive(std::istream& stream)
+        : InputArchive{this}
+        , binary_{stream}
+    {}
+
+    detail::input_sharing& sharing() { return sharing_; }
+
+    void load_binary(void* data, std::streamsize size)
+    {
+        binary_.loadBinary(data, size);
+    }
+};
+
+// The data is saved like with the cereal binary archives.
+
+template <typename T>
+std::enable_if_t<std::is_arithmetic_v<T>>
+CEREAL_SAVE_FUNCTION_NAME(shared_binary_output_archive& ar, const T& x)
+{
+    ar.save_binary(std::addressof(x), sizeof(x));
+}
+
+template <typename T>
+std::enable_if_t<std::is_arithmetic_v<T>>
+CEREAL_LOAD_FUNCTION_NAME(shared_binary_input_archive& ar, T& x)
+{
+    ar.load_binary(std::addressof(x), sizeof(x));
+}
+
+template <typename Archive, typename T>
+CEREAL_ARCHIVE_RESTRICT(shared_binary_input_archive,
+                        shared_binary_output_archive)
+CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, cereal::NameValuePair<T>& x)
+{
+    ar(x.value);
+}
+
+template <typename Archive, typename T>
+CEREAL_ARCHIVE_RESTRICT(shared_binary_input_archive,
+                        shared_binary_output_archive)
+CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, cereal::SizeTag<T>& x)
+{
+    ar(x.size);
+}
+
+template <typename T>
+void CEREAL_SAVE_FUNCTION_NAME(shared_binary_output_archive& ar,
+                               const cereal::BinaryData<T>& x)
+{
+    ar.save_binary(x.data, static_cast<std::streamsize>(x.size));
+}
+
+template <typename T>
+void CEREAL_LOAD_FUNCTION_NAME(shared_binary_input_archive& ar,
+                               cereal::BinaryData<T>& x)
+{
+    ar.load_binary(x.data, static_cast<std::streamsize>(x.size));
+}
+
+} // namespace lager
+
+CEREAL_REGISTER_ARCHIVE(lager::shared_binary_output_archive)
+CEREAL_REGISTER_ARCHIVE(lager::shared_binary_input_archive)
+CEREAL_SETUP_ARCHIVE_TRAITS(lager::shared_binary_input_archive,
+                            lager::shared_binary_output_archive)
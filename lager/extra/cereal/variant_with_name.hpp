@@ -16,50 +16,84 @@
 
 #include <boost/core/demangle.hpp>
 #include <cereal/cereal.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 
 namespace cereal {
 namespace detail {
 
-template <class Archive>
-struct variant_save_visitor
+template <typename T>
+const std::string& get_type_name()
 {
-    Archive& ar;
+    static std::string name = boost::core::demangle(typeid(T).name());
+    return name;
+}
+
+template <typename T, typename... Ts>
+constexpr std::size_t count_alternative = (std::size_t{std::is_same_v<T, Ts>} +
+                                           ... + std::size_t{});
 
-    template <class T>
-    void operator()(const T& value) const
+/*!
+ * Names of the alternatives of a variant, and the index of the alternative
+ * with a given name, computed once per variant type.
+ */
+template <typename... Ts>
+struct variant_names
+{
+    // Alternatives are told apart by the name of their type only.
+    static_assert(((count_alternative<Ts, Ts...> == 1) && ...),
+                  "variants with repeated alternatives can not be serialized "
+                  "with their type names");
+
+    static const std::string& name(std::size_t index)
     {
-        ar(CEREAL_NVP_("data", value));
+        static const auto names = std::array<const std::string*, sizeof...(Ts)>{
+            {&get_type_name<Ts>()...}};
+        return *names[index];
+    }
+
+    static std::size_t index(std::string_view name)
+    {
+        static const auto indices = [] {
+            auto result = std::unordered_map<std::string_view, std::size_t>{};
+            auto index  = std::size_t{};
+            (result.emplace(get_type_name<Ts>(), index++), ...);
+            return result;
+        }();
+        auto it = indices.find(name);
+        if (it == indices.end())
+            LAGER_THROW(::cereal::Exception("Invalid variant type name"));
+        return it->second;
     }
 };
 
-template <typename T>
-const std::string& get_type_name()
+template <std::size_t Index, class Archive, class Variant>
+void load_variant_alternative(Archive& ar, Variant& variant)
 {
-    static std::string name = boost::core::demangle(typeid(T).name());
-    return name;
+    auto value = std::variant_alternative_t<Index, Variant>{};
+    ar(CEREAL_NVP_("data", value));
+    variant.template emplace<Index>(std::move(value));
 }
 
 //! @internal
-template <int N, class Variant, class... Args, class Archive>
-typename std::enable_if<N == std::variant_size_v<Variant>, void>::type
-load_variant(Archive& /*ar*/, const std::string&, Variant&)
+template <class Archive, class Variant, std::size_t... Is>
+void load_variant(Archive& ar,
+                  std::size_t index,
+                  Variant& variant,
+                  std::index_sequence<Is...>)
 {
-    LAGER_THROW(::cereal::Exception("Invalid variant type name"));
-}
+    using loader_t = void (*)(Archive&, Variant&);
 
-template <int N, class Variant, class H, class... T, class Archive>
-    typename std::enable_if <
-    N<std::variant_size_v<Variant>, void>::type
-    load_variant(Archive& ar, const std::string& target, Variant& variant)
-{
-    if (get_type_name<H>() == target) {
-        H value;
-        ar(CEREAL_NVP_("data", value));
-        variant = std::move(value);
-    } else {
-        load_variant<N + 1, Variant, T...>(ar, target, variant);
-    }
+    static constexpr loader_t loaders[] = {
+        &load_variant_alternative<Is, Archive, Variant>...};
+    loaders[index](ar, variant);
 }
 
 } // namespace detail
@@ -68,22 +102,24 @@ template <class Archive, typename... Ts>
 inline void CEREAL_SAVE_FUNCTION_NAME(Archive& ar,
                                       const std::variant<Ts...>& variant)
 {
-    ar(CEREAL_NVP_(
-        "type",
-        std::visit([](auto x) { return detail::get_type_name<decltype(x)>(); },
-                   variant)));
-    std::visit(detail::variant_save_visitor<Archive>{ar}, variant);
+    if (variant.valueless_by_exception())
+        LAGER_THROW(std::bad_variant_access{});
+    ar(CEREAL_NVP_("type",
+                   detail::variant_names<Ts...>::name(variant.index())));
+    std::visit([&](const auto& value) { ar(CEREAL_NVP_("data", value)); },
+               variant);
 }
 
 //! Loading for std::variant
 template <class Archive, typename... Ts>
 inline void CEREAL_LOAD_FUNCTION_NAME(Archive& ar, std::variant<Ts...>& variant)
 {
-    using variant_t = typename std::variant<Ts...>;
-
     auto target = std::string{};
     ar(CEREAL_NVP_("type", target));
-    detail::load_variant<0, variant_t, Ts...>(ar, target, variant);
+    detail::load_variant(ar,
+                         detail::variant_names<Ts...>::index(target),
+                         variant,
+                         std::index_sequence_for<Ts...>{});
 }
 
 //! Serializing a std::monostate
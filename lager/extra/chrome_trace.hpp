@@ -0,0 +1,166 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/tracing.hpp>
+
+#include <cstddef>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace lager {
+
+namespace detail {
+
+inline void write_chrome_trace_ts(std::ostream& out, std::int64_t ns)
+{
+    out << ns / 1000 << '.' << std::setw(3) << std::setfill('0')
+        << (ns < 0 ? -ns : ns) % 1000 << std::setfill(' ');
+}
+
+inline void
+write_chrome_trace_event(std::ostream& out, const trace_event& ev, bool& first)
+{
+    auto name = to_string(ev.phase);
+    auto head = [&](char ph, std::int64_t ts) {
+        out << (first ? "" : ",\n") << R"({"name":")" << name
+            << R"(","cat":"lager","ph":")" << ph << R"(","pid":1,"tid":1,)"
+            << R"("ts":)";
+        write_chrome_trace_ts(out, ts);
+        first = false;
+    };
+    switch (ev.phase) {
+    case trace_phase::queue:
+    case trace_phase::effect_future:
+        // These overlap with the processing of other actions, so they are
+        // shown as async spans instead of nested slices.
+        head('b', ev.begin);
+        out << R"(,"id":)" << ev.action_id << "}";
+        head('e', ev.end);
+        out << R"(,"id":)" << ev.action_id << "}";
+        break;
+    default:
+        head('X', ev.begin);
+        out << R"(,"dur":)";
+        write_chrome_trace_ts(out, ev.end - ev.begin);
+        out << R"(,"args":{"action":)" << ev.action_id << "}}";
+        break;
+    }
+}
+
+} // namespace detail
+
+//! @defgroup tracing
+//! @{
+
+/*!
+ * Writes `events` to `out` as a JSON document in the Chrome trace event
+ * format, that can be loaded in `chrome://tracing` or
+ * [Perfetto](https://ui.perfetto.dev).
+ */
+template <typename Events>
+void write_chrome_trace(std::ostream& out, const Events& events)
+{
+    auto first = true;
+    out << "{\"traceEvents\":[\n";
+    for (auto&& ev : events)
+        detail::write_chrome_trace_event(out, ev, first);
+    out << "\n]}\n";
+}
+
+/*!
+ * Trace sink that streams the events to `out` in the Chrome trace event
+ * format.  The document is closed when the sink is destroyed.
+ */
+class chrome_trace_sink : public trace_sink
+{
+    std::ostream& out_;
+    std::mutex mutex_;
+    bool first_ = true;
+
+public:
+    chrome_trace_sink(std::ostream& out)
+        : out_{out}
+    {
+        out_ << "{\"traceEvents\":[\n";
+    }
+
+    ~chrome_trace_sink() override { out_ << "\n]}\n" << std::flush; }
+
+    void record(const trace_event& ev) override
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        detail::write_chrome_trace_event(out_, ev, first_);
+    }
+};
+
+/*!
+ * Trace sink that keeps the last `capacity` events in memory, in their compact
+ * binary form.  This is cheap enough to leave enabled in production and dump
+ * with `write_chrome_trace()` when something interesting happens.
+ */
+class trace_ring_buffer : public trace_sink
+{
+    mutable std::mutex mutex_;
+    std::vector<trace_event> events_;
+    std::size_t next_ = 0;
+    bool full_        = false;
+
+public:
+    explicit trace_ring_buffer(std::size_t capacity = 1 << 16)
+        : events_(capacity)
+    {}
+
+    void record(const trace_event& ev) override
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (events_.empty())
+            return;
+        events_[next_] = ev;
+        if (++next_ == events_.size()) {
+            next_ = 0;
+            full_ = true;
+        }
+    }
+
+    /*!
+     * Returns the recorded events, from oldest to newest.
+     */
+    std::vector<trace_event> events() const
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        auto result = std::vector<trace_event>{};
+        if (full_)
+            result.insert(result.end(), events_.begin() + next_, events_.end());
+        result.insert(result.end(), events_.begin(), events_.begin() + next_);
+        return result;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        next_ = 0;
+        full_ = false;
+    }
+
+    void write_chrome_trace(std::ostream& out) const
+    {
+        ::lager::write_chrome_trace(out, events());
+    }
+};
+
+//! @} group: tracing
+
+} // namespace lager
@@ -14,11 +14,11 @@
 
 #include <lager/config.hpp>
 
-#include <boost/hana/for_each.hpp>
 #include <boost/hana/integral_constant.hpp>
 #include <boost/hana/pair.hpp>
 #include <boost/hana/string.hpp>
 #include <boost/hana/tuple.hpp>
+#include <boost/hana/unpack.hpp>
 
 #include <boost/preprocessor/facilities/expand.hpp>
 #include <boost/preprocessor/punctuation/comma_if.hpp>
@@ -26,7 +26,11 @@
 #include <boost/preprocessor/stringize.hpp>
 #include <boost/preprocessor/variadic/to_seq.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <stdexcept>
+#include <string_view>
 #include <type_traits>
 
 namespace lager {
@@ -38,9 +42,91 @@ struct enum_meta : std::false_type
 namespace detail {
 
 template <typename T>
-struct return_from_for_each
+struct enum_entry
 {
     T value;
+    std::string_view name;
+};
+
+template <typename T>
+constexpr auto enum_underlying(T v)
+{
+    return static_cast<std::make_unsigned_t<std::underlying_type_t<T>>>(v);
+}
+
+// Stable, so the first of the names of values with aliases comes first.
+template <typename T, std::size_t N, typename Less>
+constexpr std::array<enum_entry<T>, N>
+sort_enum_entries(std::array<enum_entry<T>, N> entries, Less less)
+{
+    for (auto i = std::size_t{1}; i < N; ++i)
+        for (auto j = i; j > 0 && less(entries[j], entries[j - 1]); --j) {
+            auto tmp       = entries[j];
+            entries[j]     = entries[j - 1];
+            entries[j - 1] = tmp;
+        }
+    return entries;
+}
+
+/*!
+ * Tables for converting values of the enum `T` to and from their names,
+ * computed at compile time from `enum_meta<T>`.  When the values are
+ * consecutive, the name of a value is found by indexing, otherwise both
+ * conversions use binary search.
+ */
+template <typename T>
+struct enum_tables
+{
+    static constexpr auto entries =
+        boost::hana::unpack(enum_meta<T>::apply(), [](auto... xs) {
+            return std::array<enum_entry<T>, sizeof...(xs)>{
+                {{boost::hana::first(xs).value,
+                  std::string_view{boost::hana::second(xs).c_str()}}...}};
+        });
+
+    static constexpr auto by_value =
+        sort_enum_entries(entries, [](auto a, auto b) {
+            return enum_underlying(a.value) < enum_underlying(b.value);
+        });
+
+    static constexpr auto by_name =
+        sort_enum_entries(entries, [](auto a, auto b) {
+            return a.name < b.name;
+        });
+
+    static constexpr bool dense = [] {
+        for (auto i = std::size_t{1}; i < by_value.size(); ++i)
+            if (enum_underlying(by_value[i].value) !=
+                enum_underlying(by_value[i - 1].value) + 1)
+                return false;
+        return true;
+    }();
+
+    static const enum_entry<T>* find_value(T v)
+    {
+        if constexpr (by_value.empty()) {
+            return nullptr;
+        } else if constexpr (dense) {
+            auto i = static_cast<std::size_t>(
+                enum_underlying(v) - enum_underlying(by_value[0].value));
+            return i < by_value.size() ? &by_value[i] : nullptr;
+        } else {
+            auto it = std::lower_bound(
+                by_value.begin(), by_value.end(), v, [](auto e, auto v) {
+                    return enum_underlying(e.value) < enum_underlying(v);
+                });
+            return it != by_value.end() && it->value == v ? &*it : nullptr;
+        }
+    }
+
+    static const enum_entry<T>* find_name(std::string_view n)
+    {
+        auto it = std::lower_bound(
+            by_name.begin(), by_name.end(), n, [](auto e, auto n) {
+                return e.name < n;
+            });
+        return it != by_name.end() && it->name == n ? &*it : nullptr;
+    }
 };
 
 } // namespace detail
@@ -48,30 +134,16 @@ struct return_from_for_each
 template <typename T, std::enable_if_t<enum_meta<T>::value, int> = 0>
 const char* to_string(T v)
 {
-    LAGER_TRY {
-        boost::hana::for_each(enum_meta<T>::apply(), [&](auto&& x) {
-            if (boost::hana::first(x).value == v)
-                LAGER_THROW(detail::return_from_for_each<const char*>{
-                    boost::hana::second(x).c_str()});
-        });
-    } LAGER_CATCH(detail::return_from_for_each<const char*> x) {
-        return x.value;
-    }
+    if (auto entry = detail::enum_tables<T>::find_value(v))
+        return entry->name.data();
     LAGER_THROW(std::runtime_error{"unknown enum value"});
 }
 
 template <typename T, std::enable_if_t<enum_meta<T>::value, int> = 0>
-T to_enum(const std::string& v)
+T to_enum(std::string_view v)
 {
-    LAGER_TRY {
-        boost::hana::for_each(enum_meta<T>::apply(), [&](auto&& x) {
-            if (boost::hana::second(x).c_str() == v)
-                LAGER_THROW(detail::return_from_for_each<T>{
-                    boost::hana::first(x).value});
-        });
-    } LAGER_CATCH(detail::return_from_for_each<T> x) {
-        return x.value;
-    }
+    if (auto entry = detail::enum_tables<T>::find_name(v))
+        return entry->value;
     LAGER_THROW(std::runtime_error{"unknown enum name"});
 }
 
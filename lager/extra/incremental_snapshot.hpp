@@ -0,0 +1,681 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+
+#pragma once
+
+#include <lager/extra/snapshot.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<immer/algorithm.hpp>)
+#include <immer/algorithm.hpp>
+#define LAGER_SNAPSHOT_USE_IMMER_DIFF 1
+#endif
+
+namespace lager {
+
+namespace detail {
+
+enum class snapshot_diff : std::uint8_t
+{
+    unchanged,
+    replaced,
+    patched,
+};
+
+template <typename T>
+using snapshot_root_t = decltype(std::declval<const T&>().impl().root);
+
+template <typename T>
+using snapshot_tail_t = decltype(std::declval<const T&>().impl().tail);
+
+template <typename T>
+using snapshot_mapped_t = typename T::mapped_type;
+
+template <typename T>
+using snapshot_persistent_set_t = std::enable_if_t<std::is_same_v<
+    decltype(std::declval<T>().set(std::declval<std::size_t>(),
+                                   std::declval<typename T::value_type>())),
+    T>>;
+
+template <typename T>
+using snapshot_assign_at_t =
+    decltype(std::declval<T&>()[std::size_t{}] =
+                 std::declval<typename T::value_type>());
+
+template <typename T>
+using snapshot_persistent_erase_t = std::enable_if_t<std::is_same_v<
+    decltype(std::declval<T>().erase(std::declval<typename T::key_type>())),
+    T>>;
+
+template <typename T>
+using snapshot_erase_value_t = decltype(std::declval<T&>().erase(
+    std::declval<const typename T::value_type&>()));
+
+template <typename T>
+using snapshot_slice_t =
+    decltype(std::declval<const T&>().drop(std::size_t{}).take(std::size_t{}));
+
+// Sets, whose elements are their own keys.
+template <typename T>
+constexpr bool is_snapshot_set =
+    is_snapshot_associative<T> &&
+    !zug::meta::is_detected<snapshot_mapped_t, T>::value &&
+    zug::meta::is_detected<snapshot_erase_value_t, T>::value;
+
+// Immer maps, sets and tables, whose differences can be found without
+// visiting the nodes that they share.
+template <typename T>
+constexpr bool is_snapshot_champ =
+#if LAGER_SNAPSHOT_USE_IMMER_DIFF
+    is_snapshot_associative<T> &&
+    zug::meta::is_detected<snapshot_root_t, T>::value;
+#else
+    false;
+#endif
+
+// Containers of elements identified by a key derived from them, like immer
+// tables.
+template <typename T>
+constexpr bool is_snapshot_table =
+    is_snapshot_champ<T> &&
+    !zug::meta::is_detected<snapshot_mapped_t, T>::value &&
+    !is_snapshot_set<T>;
+
+// Sequences whose elements can be updated in place by index.
+template <typename T>
+constexpr bool is_snapshot_indexed =
+    !std::is_same_v<T, std::string> &&
+    !is_snapshot_associative<T> &&
+    (zug::meta::is_detected<snapshot_persistent_set_t, T>::value ||
+     zug::meta::is_detected<snapshot_assign_at_t, T>::value);
+
+// Types whose changes can be written as a patch on the old value, instead of
+// the whole new value.
+template <typename T>
+constexpr bool is_snapshot_patchable =
+    !is_snapshot_blittable<T> &&
+    (boost::hana::Struct<T>::value ||
+     zug::meta::is_detected<snapshot_box_t, T>::value ||
+     is_snapshot_optional<T>::value ||
+     zug::meta::is_detected<snapshot_mapped_t, T>::value ||
+     is_snapshot_set<T> || is_snapshot_table<T> || is_snapshot_indexed<T>);
+
+// Whether both values are known to be the same without comparing them,
+// because they share their immer nodes.
+template <typename T>
+bool snapshot_identical(const T& old, const T& x)
+{
+    if constexpr (zug::meta::is_detected<snapshot_root_t, T>::value) {
+        if constexpr (zug::meta::is_detected<snapshot_tail_t, T>::value)
+            if (old.impl().tail != x.impl().tail)
+                return false;
+        return old.impl().root == x.impl().root && old.size() == x.size();
+    } else if constexpr (zug::meta::is_detected<snapshot_box_t, T>::value) {
+        return &old.get() == &x.get();
+    } else {
+        return false;
+    }
+}
+
+template <typename T>
+bool save_snapshot_diff(snapshot_writer& w, const T& old, const T& x);
+
+template <typename T>
+void load_snapshot_diff(snapshot_reader& r, T& x);
+
+// Writes a count of entries that is only known after writing them.
+class snapshot_count
+{
+    snapshot_writer& w_;
+    std::size_t pos_;
+    std::uint64_t count_ = 0;
+
+public:
+    snapshot_count(snapshot_writer& w)
+        : w_{w}
+        , pos_{w.size()}
+    {
+        w_.write(count_);
+    }
+
+    void add() { ++count_; }
+
+    bool finish()
+    {
+        w_.patch(pos_, count_);
+        return count_ > 0;
+    }
+};
+
+// Writes the diff of an entry after its `key`, dropping both when the entry
+// did not change.
+template <typename Key, typename T>
+void save_snapshot_entry_diff(snapshot_writer& w,
+                              snapshot_count& count,
+                              const Key& key,
+                              const T& old,
+                              const T& x)
+{
+    auto pos = w.size();
+    save_snapshot_value(w, key);
+    if (save_snapshot_diff(w, old, x))
+        count.add();
+    else
+        w.truncate(pos);
+}
+
+constexpr struct
+{
+    template <typename... Ts>
+    void operator()(const Ts&...) const
+    {}
+} ignore_snapshot_change{};
+
+// Calls `added` and `removed` with the elements only in `x` or `old`, and
+// `changed` with both elements of the entries of maps that are in both and may
+// differ.  Immer containers are compared with `immer::diff`, which does not
+// visit the nodes that they share.
+template <typename T, typename AddedFn, typename RemovedFn, typename ChangedFn>
+void diff_snapshot_elements(const T& old,
+                            const T& x,
+                            AddedFn&& added,
+                            RemovedFn&& removed,
+                            ChangedFn&& changed)
+{
+    if constexpr (is_snapshot_champ<T>) {
+#if LAGER_SNAPSHOT_USE_IMMER_DIFF
+        immer::diff(old, x, added, removed, changed);
+#endif
+    } else if constexpr (zug::meta::is_detected<snapshot_mapped_t, T>::value) {
+        for (const auto& v : old)
+            if (!x.count(v.first))
+                removed(v);
+        for (const auto& v : x) {
+            auto it = old.find(v.first);
+            if (it == old.end())
+                added(v);
+            else
+                changed(*it, v);
+        }
+    } else {
+        for (const auto& v : old)
+            if (!x.count(v))
+                removed(v);
+        for (const auto& v : x)
+            if (!old.count(v))
+                added(v);
+    }
+}
+
+// Writes the elements in [first, last) that changed.  The range is split in
+// halves that are compared whole, which for immer flex vectors does not
+// visit the nodes that they share, so only the paths to the changed elements
+// are visited.
+template <typename T>
+void save_snapshot_slice_diff(snapshot_writer& w,
+                              snapshot_count& count,
+                              const T& old,
+                              const T& x,
+                              std::size_t first,
+                              std::size_t last)
+{
+    constexpr auto leaf_size = std::size_t{32};
+    auto size                = last - first;
+    if (size > leaf_size) {
+        if (old.drop(first).take(size) == x.drop(first).take(size))
+            return;
+        auto middle = first + size / 2;
+        save_snapshot_slice_diff(w, count, old, x, first, middle);
+        save_snapshot_slice_diff(w, count, old, x, middle, last);
+    } else {
+        for (auto i = first; i < last; ++i)
+            save_snapshot_entry_diff(
+                w, count, static_cast<std::uint64_t>(i), old[i], x[i]);
+    }
+}
+
+template <typename T>
+bool save_snapshot_patch(snapshot_writer& w, const T& old, const T& x)
+{
+    if constexpr (boost::hana::Struct<T>::value) {
+        auto changed = false;
+        boost::hana::for_each(boost::hana::accessors<T>(), [&](auto&& acc) {
+            auto&& get = boost::hana::second(acc);
+            changed    = save_snapshot_diff(w, get(old), get(x)) || changed;
+        });
+        return changed;
+    } else if constexpr (zug::meta::is_detected<snapshot_box_t, T>::value) {
+        return save_snapshot_diff(w, old.get(), x.get());
+    } else if constexpr (is_snapshot_optional<T>::value) {
+        return save_snapshot_diff(w, *old, *x);
+    } else if constexpr (zug::meta::is_detected<snapshot_mapped_t, T>::value) {
+        auto erased = snapshot_count{w};
+        diff_snapshot_elements(
+            old,
+            x,
+            ignore_snapshot_change,
+            [&](const auto& v) {
+                save_snapshot_value(w, v.first);
+                erased.add();
+            },
+            ignore_snapshot_change);
+        auto updated = snapshot_count{w};
+        diff_snapshot_elements(
+            old,
+            x,
+            [&](const auto& v) {
+                save_snapshot_value(w, v.first);
+                w.write(snapshot_diff::replaced);
+                save_snapshot_value(w, v.second);
+                updated.add();
+            },
+            ignore_snapshot_change,
+            [&](const auto& o, const auto& v) {
+                save_snapshot_entry_diff(
+                    w, updated, v.first, o.second, v.second);
+            });
+        auto changed = erased.finish();
+        return updated.finish() || changed;
+    } else if constexpr (is_snapshot_set<T> || is_snapshot_table<T>) {
+        // Table elements can not be erased without their key, so tables are
+        // only patched when nothing was erased (@see `can_patch_snapshot`).
+        auto erased = snapshot_count{w};
+        if constexpr (is_snapshot_set<T>)
+            diff_snapshot_elements(
+                old,
+                x,
+                ignore_snapshot_change,
+                [&](const auto& v) {
+                    save_snapshot_value(w, v);
+                    erased.add();
+                },
+                ignore_snapshot_change);
+        auto inserted = snapshot_count{w};
+        auto insert   = [&](const auto& v) {
+            save_snapshot_value(w, v);
+            inserted.add();
+        };
+        diff_snapshot_elements(
+            old,
+            x,
+            insert,
+            ignore_snapshot_change,
+            [&](const auto&, const auto& v) { insert(v); });
+        auto changed = erased.finish();
+        return inserted.finish() || changed;
+    } else if constexpr (zug::meta::is_detected<snapshot_slice_t, T>::value) {
+        auto updated = snapshot_count{w};
+        save_snapshot_slice_diff(w, updated, old, x, 0, x.size());
+        return updated.finish();
+    } else {
+        auto updated = snapshot_count{w};
+        auto index   = std::uint64_t{};
+        auto it      = old.begin();
+        for (const auto& v : x)
+            save_snapshot_entry_diff(w, updated, index++, *it++, v);
+        return updated.finish();
+    }
+}
+
+template <typename T>
+bool erases_snapshot_elements(const T& old, const T& x)
+{
+    auto erased = false;
+    diff_snapshot_elements(
+        old,
+        x,
+        ignore_snapshot_change,
+        [&](const auto&) { erased = true; },
+        ignore_snapshot_change);
+    return erased;
+}
+
+template <typename T>
+bool can_patch_snapshot(const T& old, const T& x)
+{
+    if constexpr (is_snapshot_optional<T>::value)
+        return old && x;
+    else if constexpr (is_snapshot_indexed<T>)
+        return old.size() == x.size();
+    else if constexpr (is_snapshot_table<T>)
+        return !erases_snapshot_elements(old, x);
+    else
+        return true;
+}
+
+// Writes the changes from `old` to `x`, returning whether there were any.
+template <typename T>
+bool save_snapshot_diff(snapshot_writer& w, const T& old, const T& x)
+{
+    auto pos = w.size();
+    if (!snapshot_identical(old, x)) {
+        if constexpr (is_snapshot_patchable<T>) {
+            if (can_patch_snapshot(old, x)) {
+                w.write(snapshot_diff::patched);
+                if (save_snapshot_patch(w, old, x))
+                    return true;
+                w.truncate(pos);
+                w.write(snapshot_diff::unchanged);
+                return false;
+            }
+        }
+        if (!(old == x)) {
+            w.write(snapshot_diff::replaced);
+            save_snapshot_value(w, x);
+            return true;
+        }
+    }
+    w.write(snapshot_diff::unchanged);
+    return false;
+}
+
+template <typename T>
+void load_snapshot_patch(snapshot_reader& r, T& x)
+{
+    if constexpr (boost::hana::Struct<T>::value) {
+        boost::hana::for_each(boost::hana::accessors<T>(), [&](auto&& acc) {
+            load_snapshot_diff(r, boost::hana::second(acc)(x));
+        });
+    } else if constexpr (zug::meta::is_detected<snapshot_box_t, T>::value) {
+        auto v = x.get();
+        load_snapshot_diff(r, v);
+        x = T{std::move(v)};
+    } else if constexpr (is_snapshot_optional<T>::value) {
+        if (!x)
+            LAGER_THROW(snapshot_error{"corrupted snapshot"});
+        load_snapshot_diff(r, *x);
+    } else if constexpr (zug::meta::is_detected<snapshot_mapped_t, T>::value) {
+        constexpr auto persistent =
+            zug::meta::is_detected<snapshot_persistent_erase_t, T>::value;
+        for (auto n = load_snapshot_size(r); n; --n) {
+            auto k = typename T::key_type{};
+            load_snapshot_value(r, k);
+            if constexpr (persistent)
+                x = std::move(x).erase(k);
+            else
+                x.erase(k);
+        }
+        for (auto n = load_snapshot_size(r); n; --n) {
+            auto k = typename T::key_type{};
+            load_snapshot_value(r, k);
+            auto v = x.count(k) ? x.at(k) : typename T::mapped_type{};
+            load_snapshot_diff(r, v);
+            if constexpr (persistent)
+                x = std::move(x).set(std::move(k), std::move(v));
+            else
+                x.insert_or_assign(std::move(k), std::move(v));
+        }
+    } else if constexpr (is_snapshot_set<T> || is_snapshot_table<T>) {
+        using element_t = snapshot_element_t<typename T::value_type>;
+        if constexpr (is_snapshot_set<T>) {
+            for (auto n = load_snapshot_size(r); n; --n) {
+                auto v = element_t{};
+                load_snapshot_value(r, v);
+                if constexpr (std::is_same_v<snapshot_erase_value_t<T>, T>)
+                    x = std::move(x).erase(v);
+                else
+                    x.erase(v);
+            }
+        } else if (load_snapshot_size(r)) {
+            LAGER_THROW(snapshot_error{"corrupted snapshot"});
+        }
+        for (auto n = load_snapshot_size(r); n; --n) {
+            auto v = element_t{};
+            load_snapshot_value(r, v);
+            if constexpr (zug::meta::is_detected<snapshot_persistent_insert_t,
+                                                 T>::value)
+                x = std::move(x).insert(std::move(v));
+            else
+                x.insert(std::move(v));
+        }
+    } else if constexpr (is_snapshot_indexed<T>) {
+        for (auto n = load_snapshot_size(r); n; --n) {
+            auto i = std::uint64_t{};
+            load_snapshot_value(r, i);
+            if (i >= x.size())
+                LAGER_THROW(snapshot_error{"corrupted snapshot"});
+            auto v = typename T::value_type(x[i]);
+            load_snapshot_diff(r, v);
+            if constexpr (zug::meta::is_detected<snapshot_persistent_set_t,
+                                                 T>::value)
+                x = std::move(x).set(i, std::move(v));
+            else
+                x[i] = std::move(v);
+        }
+    } else {
+        LAGER_THROW(snapshot_error{"corrupted snapshot"});
+    }
+}
+
+template <typename T>
+void load_snapshot_diff(snapshot_reader& r, T& x)
+{
+    auto diff = snapshot_diff{};
+    r.read(diff);
+    switch (diff) {
+    case snapshot_diff::unchanged:
+        break;
+    case snapshot_diff::replaced:
+        load_snapshot_value(r, x);
+        break;
+    case snapshot_diff::patched:
+        load_snapshot_patch(r, x);
+        break;
+    default:
+        LAGER_THROW(snapshot_error{"corrupted snapshot"});
+    }
+}
+
+// A random number identifying a full snapshot, which its deltas refer to.
+inline std::uint64_t make_snapshot_generation()
+{
+    auto device = std::random_device{};
+    auto time   = std::chrono::steady_clock::now().time_since_epoch().count();
+    return ((std::uint64_t{device()} << 32) ^ device()) ^
+           static_cast<std::uint64_t>(time);
+}
+
+inline std::vector<char> read_snapshot_log(const std::string& fname)
+{
+    auto is = std::ifstream{fname, std::ios::binary};
+    return {std::istreambuf_iterator<char>{is},
+            std::istreambuf_iterator<char>{}};
+}
+
+} // namespace detail
+
+//! @addtogroup snapshots
+//! @{
+
+/*!
+ * Persists successive versions of a model in the snapshot file `fname`,
+ * writing only what changed since the last time it was saved.
+ *
+ * The first `save()` writes a full snapshot.  The next ones append to a
+ * log, in the file `fname` with the `.delta` suffix, the parts of the model
+ * that changed.  Unchanged immer containers and boxes are detected in
+ * constant time because they share their nodes with the previous model,
+ * structs defined with `LAGER_STRUCT` are compared field by field, and only
+ * the updated elements of sequences, maps and sets are written.  The
+ * changes of immer maps, sets and tables are found with `immer::diff`, and
+ * immer flex vectors are compared in slices, so the nodes that they share
+ * with the previous model are not visited and the time to save depends on
+ * the amount of changes.  Finding the changes of other containers, like the
+ * standard ones or `immer::vector`, visits all their elements.
+ *
+ * Every type in the model must be equality comparable, because the values
+ * that are not patched are compared with `operator==`.  `LAGER_STRUCT`
+ * defines it, but structs adapted to Boost.Hana otherwise need their own.
+ *
+ * Once `max_deltas` changes have been logged, or the log gets bigger than
+ * the full snapshot, the next `save()` compacts them into a new full
+ * snapshot.  `load()` restores the full snapshot and applies the log.
+ * Every full snapshot gets a random generation number that its deltas refer
+ * to, so the deltas left behind by an interrupted compaction are never
+ * applied to the new one, even when it has the same contents as the old one.
+ * Because of it, the full snapshot can not be read with `load_snapshot()`.
+ *
+ * @note Sequences that change their size, tables from which elements are
+ *       erased and values of other types are written whole when they
+ *       change.
+ */
+template <typename T>
+class incremental_snapshot
+{
+    std::string fname_;
+    std::string delta_fname_;
+    std::uint32_t version_;
+    std::size_t max_deltas_;
+
+    std::optional<T> last_;
+    std::uint64_t generation_ = 0;
+    std::size_t base_size_    = 0;
+    std::size_t delta_size_   = 0;
+    std::size_t deltas_       = 0;
+
+public:
+    incremental_snapshot(std::string fname,
+                         std::uint32_t version  = 0,
+                         std::size_t max_deltas = 64)
+        : fname_{std::move(fname)}
+        , delta_fname_{fname_ + ".delta"}
+        , version_{version}
+        , max_deltas_{max_deltas}
+    {}
+
+    /*!
+     * Restores the model from the files and takes it as the last saved
+     * model.  Raises `snapshot_error` when they can not be read.
+     */
+    T load()
+    {
+        auto file   = detail::snapshot_file{fname_};
+        auto base =
+            detail::snapshot_reader{file.data(), file.size(), version_};
+        auto result = T{};
+        base.read(generation_);
+        detail::load_snapshot_value(base, result);
+        base.finish();
+        base_size_ = file.size();
+        deltas_    = 0;
+
+        // Deltas of a previous full snapshot are left behind when
+        // compacting is interrupted, they are skipped.  An interrupted save
+        // leaves a truncated or otherwise invalid delta at the end of the
+        // log, the log is cut before it.  The log is then rewritten without
+        // them, so that the next deltas are not appended after them.
+        auto log  = detail::read_snapshot_log(delta_fname_);
+        auto kept = std::vector<char>{};
+        auto pos  = std::size_t{};
+        while (log.size() - pos >= sizeof(std::uint64_t)) {
+            auto size = std::uint64_t{};
+            std::memcpy(&size, log.data() + pos, sizeof(size));
+            auto record = log.data() + pos;
+            if (size > log.size() - pos - sizeof(size) ||
+                detail::check_snapshot(record + sizeof(size), size, version_))
+                break;
+            auto r = detail::snapshot_reader{
+                record + sizeof(size), size, version_};
+            auto generation = std::uint64_t{};
+            r.read(generation);
+            pos += sizeof(size) + size;
+            if (generation == generation_) {
+                detail::load_snapshot_diff(r, result);
+                r.finish();
+                kept.insert(kept.end(), record, log.data() + pos);
+                ++deltas_;
+            }
+        }
+        if (kept.size() != log.size()) {
+            if (kept.empty())
+                std::remove(delta_fname_.c_str());
+            else
+                detail::write_snapshot_file(delta_fname_, kept);
+        }
+        delta_size_ = kept.size();
+        last_       = result;
+        return result;
+    }
+
+    /*!
+     * Saves the changes since the last saved or loaded model.
+     */
+    void save(const T& value)
+    {
+        if (!last_ || deltas_ >= max_deltas_ || delta_size_ > base_size_) {
+            compact(value);
+            return;
+        }
+        auto w = detail::snapshot_writer{};
+        w.write(generation_);
+        if (!detail::save_snapshot_diff(w, *last_, value)) {
+            last_ = value;
+            return;
+        }
+        auto record = std::move(w).finish(version_);
+        auto size   = static_cast<std::uint64_t>(record.size());
+        {
+            auto os = std::ofstream{delta_fname_,
+                                    std::ios::binary | std::ios::app};
+            os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            os.write(record.data(), static_cast<std::streamsize>(size));
+            if (!os.flush())
+                LAGER_THROW(snapshot_error{"could not write snapshot: " +
+                                           delta_fname_});
+        }
+        last_ = value;
+        delta_size_ += sizeof(size) + record.size();
+        ++deltas_;
+    }
+
+    /*!
+     * Saves `value` as a full snapshot and discards the log of changes.
+     */
+    void compact(const T& value)
+    {
+        auto generation = detail::make_snapshot_generation();
+        auto w          = detail::snapshot_writer{};
+        w.write(generation);
+        detail::save_snapshot_value(w, value);
+        auto data = std::move(w).finish(version_);
+        detail::write_snapshot_file(fname_, data);
+        std::remove(delta_fname_.c_str());
+        last_       = value;
+        generation_ = generation;
+        base_size_  = data.size();
+        delta_size_ = 0;
+        deltas_     = 0;
+    }
+
+    /*!
+     * Number of changes in the log since the last full snapshot.
+     */
+    std::size_t deltas() const { return deltas_; }
+};
+
+//! @}
+
+} // namespace lager
@@ -0,0 +1,264 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/config.hpp>
+#include <lager/detail/lru_cache.hpp>
+#include <lager/lens.hpp>
+#include <lager/lenses.hpp>
+#include <lager/lenses/at.hpp>
+#include <lager/lenses/optional.hpp>
+#include <lager/lenses/traversal.hpp>
+#include <lager/lenses/variant.hpp>
+
+#include <zug/meta/detected.hpp>
+
+#include <boost/hana/accessors.hpp>
+#include <boost/hana/concept/struct.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/pair.hpp>
+
+#include <charconv>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace lager {
+
+namespace detail {
+
+using path_segments = std::vector<std::string>;
+
+// Splits a path like `todos/42/text` or a JSON-Pointer like `/todos/42/text`
+// in its segments, unescaping `~1` and `~0` in the latter.
+inline path_segments parse_path(std::string_view path)
+{
+    auto json_pointer = !path.empty() && path.front() == '/';
+    if (json_pointer)
+        path.remove_prefix(1);
+    auto segments = path_segments{};
+    if (path.empty())
+        return segments;
+    auto segment = std::string{};
+    for (auto it = path.begin(); it != path.end(); ++it) {
+        if (*it == '/') {
+            segments.push_back(std::move(segment));
+            segment.clear();
+        } else if (json_pointer && *it == '~' && it + 1 != path.end() &&
+                   (it[1] == '0' || it[1] == '1')) {
+            segment += *++it == '0' ? '~' : '/';
+        } else {
+            segment += *it;
+        }
+    }
+    segments.push_back(std::move(segment));
+    return segments;
+}
+
+template <typename Key>
+std::optional<Key> parse_path_key(const std::string& segment)
+{
+    if constexpr (std::is_constructible_v<Key, const std::string&>) {
+        return Key(segment);
+    } else if constexpr (std::is_integral_v<Key>) {
+        auto key    = Key{};
+        auto last   = segment.data() + segment.size();
+        auto [p, e] = std::from_chars(segment.data(), last, key);
+        if (e != std::errc{} || p != last)
+            return std::nullopt;
+        return key;
+    } else {
+        return std::nullopt;
+    }
+}
+
+template <typename T>
+struct is_variant : std::false_type
+{};
+
+template <typename... Ts>
+struct is_variant<std::variant<Ts...>> : std::true_type
+{};
+
+template <typename T, typename Key>
+using at_t = decltype(std::declval<const T&>().at(std::declval<Key>()));
+
+template <typename Accessor>
+auto accessor_lens(Accessor acc)
+{
+    return lenses::getset(
+        [acc](auto&& whole) -> decltype(auto) { return acc(LAGER_FWD(whole)); },
+        [acc](auto whole, auto&& part) {
+            acc(whole) = LAGER_FWD(part);
+            return whole;
+        });
+}
+
+template <typename Whole, typename Part>
+using path_lens_t = lens<Whole, std::optional<Part>>;
+
+template <typename Whole, typename Part, std::size_t... Is>
+std::optional<path_lens_t<Whole, Part>>
+compile_alternative(const path_segments& segments,
+                    std::size_t index,
+                    std::size_t alt,
+                    std::index_sequence<Is...>);
+
+/*!
+ * Returns a lens following the segments from the `index`-th on in a `Whole`,
+ * or nothing if they do not name a `Part` in it.  Structs defined with
+ * `LAGER_STRUCT` are navigated by member name, containers by key or index
+ * and variants by alternative index.  Optionals are navigated transparently.
+ */
+template <typename Whole, typename Part>
+std::optional<path_lens_t<Whole, Part>>
+compile_path(const path_segments& segments, std::size_t index)
+{
+    using result_t = std::optional<path_lens_t<Whole, Part>>;
+    if constexpr (std::is_same_v<Whole, Part>) {
+        if (index == segments.size())
+            return result_t{lenses::force_opt};
+    }
+    if constexpr (lenses::detail::is_optional<Whole>::value) {
+        using value_t = typename Whole::value_type;
+        if (auto l = compile_path<value_t, Part>(segments, index))
+            return result_t{lenses::bind_opt(*std::move(l))};
+        return std::nullopt;
+    } else if (index == segments.size()) {
+        return std::nullopt;
+    } else if constexpr (boost::hana::Struct<Whole>::value) {
+        auto result = result_t{};
+        boost::hana::for_each(
+            boost::hana::accessors<Whole>(), [&](auto&& member) {
+                if (result || boost::hana::first(member).c_str() !=
+                                  std::string_view{segments[index]})
+                    return;
+                auto acc       = boost::hana::second(member);
+                using member_t = std::decay_t<decltype(acc(
+                    std::declval<const Whole&>()))>;
+                if (auto l = compile_path<member_t, Part>(segments, index + 1))
+                    result = accessor_lens(acc) | *std::move(l);
+            });
+        return result;
+    } else if constexpr (is_variant<Whole>::value) {
+        auto alt = parse_path_key<std::size_t>(segments[index]);
+        if (!alt)
+            return std::nullopt;
+        return compile_alternative<Whole, Part>(
+            segments,
+            index,
+            *alt,
+            std::make_index_sequence<std::variant_size_v<Whole>>{});
+    } else if constexpr (zug::meta::is_detected<
+                             at_t,
+                             Whole,
+                             lenses::detail::position_t<Whole>>::value) {
+        using key_t   = lenses::detail::position_t<Whole>;
+        using value_t = std::decay_t<at_t<Whole, key_t>>;
+        auto key      = parse_path_key<key_t>(segments[index]);
+        if (!key)
+            return std::nullopt;
+        if (auto l = compile_path<value_t, Part>(segments, index + 1))
+            return result_t{lenses::at(*std::move(key)) |
+                            lenses::bind_opt(*std::move(l))};
+        return std::nullopt;
+    } else {
+        return std::nullopt;
+    }
+}
+
+template <typename Whole, typename Part, std::size_t... Is>
+std::optional<path_lens_t<Whole, Part>>
+compile_alternative(const path_segments& segments,
+                    std::size_t index,
+                    std::size_t alt,
+                    std::index_sequence<Is...>)
+{
+    auto result = std::optional<path_lens_t<Whole, Part>>{};
+    (
+        [&] {
+            using alt_t = std::variant_alternative_t<Is, Whole>;
+            if (Is == alt) {
+                if (auto l = compile_path<alt_t, Part>(segments, index + 1))
+                    result = lenses::alternative<alt_t> |
+                             lenses::bind_opt(*std::move(l));
+            }
+        }(),
+        ...);
+    return result;
+}
+
+// The keys of the cache of `path_lens` point into the path owned by the
+// entry, so that looking a path up does not allocate.
+template <typename Lens>
+struct path_lens_entry
+{
+    std::unique_ptr<const std::string> path;
+    Lens lens;
+};
+
+} // namespace detail
+
+//! @defgroup lenses
+//! @{
+
+/*!
+ * Maximum number of compiled paths that `path_lens` keeps, per thread and
+ * pair of model and part types.
+ */
+constexpr auto path_lens_cache_capacity = std::size_t{256};
+
+/*!
+ * `string -> Lens<Model, [Part]>`
+ *
+ * Returns a lens focusing the part of a `Model` named by a runtime `path`,
+ * like `todos/42/text`, or the equivalent JSON-Pointer `/todos/42/text`.
+ * Every segment of the path names a member of a struct defined with
+ * `LAGER_STRUCT`, a key or index of a container, or the index of the
+ * alternative of a variant.  Optionals are followed transparently.
+ *
+ * The path is compiled into a chain of `attr`, `at` and `alternative` lenses
+ * and cached, so using the same path again does not parse it again.
+ *
+ * @throw std::invalid_argument when the path does not name a `Part` in a
+ *        `Model`.
+ */
+template <typename Model, typename Part>
+lens<Model, std::optional<Part>> path_lens(std::string_view path)
+{
+    using lens_t  = lens<Model, std::optional<Part>>;
+    using entry_t = detail::path_lens_entry<lens_t>;
+    thread_local auto cache =
+        detail::lru_cache<std::string_view, entry_t>{path_lens_cache_capacity};
+    if (auto entry = cache.find(path))
+        return entry->lens;
+    auto l = detail::compile_path<Model, Part>(detail::parse_path(path), 0);
+    if (!l)
+        LAGER_THROW(std::invalid_argument{"invalid path: " +
+                                          std::string{path}});
+    auto entry =
+        entry_t{std::make_unique<const std::string>(path), *std::move(l)};
+    auto key   = std::string_view{*entry.path};
+    return cache.insert(key, std::move(entry)).lens;
+}
+
+//! @}
+
+} // namespace lager
@@ -0,0 +1,662 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+
+#pragma once
+
+#include <lager/config.hpp>
+
+#include <zug/meta/detected.hpp>
+
+#include <boost/hana/accessors.hpp>
+#include <boost/hana/concept/struct.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/pair.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LAGER_SNAPSHOT_USE_MMAP 1
+#define LAGER_SNAPSHOT_USE_FSYNC 1
+#endif
+
+namespace lager {
+
+//! @defgroup snapshots
+//! @{
+
+/*!
+ * Raised when a snapshot can not be read, because it is corrupted, truncated,
+ * it was written by an incompatible version of the library or for another
+ * version of the model.
+ */
+struct snapshot_error : std::runtime_error
+{
+    using std::runtime_error::runtime_error;
+};
+
+/*!
+ * Version of the binary layout of the snapshots written by this library.
+ */
+constexpr std::uint32_t snapshot_format_version = 2;
+
+//! @}
+
+namespace detail {
+
+struct snapshot_header
+{
+    char magic[8];
+    std::uint32_t format;
+    std::uint32_t version;
+    std::uint64_t size;
+    std::uint64_t checksum;
+};
+
+static_assert(sizeof(snapshot_header) == 32, "unexpected padding");
+
+constexpr char snapshot_magic[8] = {'L', 'A', 'G', 'E', 'R', 'S', 'N', 'P'};
+
+inline std::uint64_t snapshot_mix(std::uint64_t hash, std::uint64_t word)
+{
+    hash = (hash ^ word) * 0x9e3779b97f4a7c15ull;
+    return hash ^ (hash >> 32);
+}
+
+// Hashes a word at a time, so that validating hundreds of megabytes at
+// startup is limited by the memory bandwidth.  Every step is invertible, so
+// changing any single word always changes the result.
+inline std::uint64_t snapshot_checksum(const char* data, std::size_t size)
+{
+    auto hash = std::uint64_t{14695981039346656037ull};
+    auto word = std::uint64_t{};
+    auto last = data + size / sizeof(word) * sizeof(word);
+    for (auto p = data; p != last; p += sizeof(word)) {
+        std::memcpy(&word, p, sizeof(word));
+        hash = snapshot_mix(hash, word);
+    }
+    if (auto rest = size % sizeof(word)) {
+        word = 0;
+        std::memcpy(&word, last, rest);
+        hash = snapshot_mix(hash, word);
+    }
+    return snapshot_mix(hash, size);
+}
+
+class snapshot_writer
+{
+    std::vector<char> buffer_ = std::vector<char>(sizeof(snapshot_header));
+
+public:
+    void write_bytes(const void* data, std::size_t size)
+    {
+        auto p = static_cast<const char*>(data);
+        buffer_.insert(buffer_.end(), p, p + size);
+    }
+
+    template <typename T>
+    void write(const T& value)
+    {
+        write_bytes(&value, sizeof(T));
+    }
+
+    // Positions are relative to the beginning of the snapshot, which is
+    // suitably aligned in memory by `new` and `mmap`.
+    void align(std::size_t alignment)
+    {
+        buffer_.resize((buffer_.size() + alignment - 1) / alignment *
+                       alignment);
+    }
+
+    char* grow(std::size_t size)
+    {
+        auto pos = buffer_.size();
+        buffer_.resize(pos + size);
+        return buffer_.data() + pos;
+    }
+
+    std::size_t size() const { return buffer_.size(); }
+
+    void truncate(std::size_t size) { buffer_.resize(size); }
+
+    template <typename T>
+    void patch(std::size_t pos, const T& value)
+    {
+        std::memcpy(buffer_.data() + pos, &value, sizeof(T));
+    }
+
+    std::vector<char> finish(std::uint32_t version) &&
+    {
+        auto header     = snapshot_header{};
+        auto payload    = buffer_.data() + sizeof(snapshot_header);
+        header.format   = snapshot_format_version;
+        header.version  = version;
+        header.size     = buffer_.size() - sizeof(snapshot_header);
+        header.checksum = snapshot_checksum(payload, header.size);
+        std::memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+        std::memcpy(buffer_.data(), &header, sizeof(header));
+        return std::move(buffer_);
+    }
+};
+
+/*!
+ * Returns why `data` is not a valid snapshot of the model `version`, or null
+ * when it is.
+ */
+inline const char*
+check_snapshot(const char* data, std::size_t size, std::uint32_t version)
+{
+    auto header = snapshot_header{};
+    if (size < sizeof(header))
+        return "truncated snapshot";
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)))
+        return "not a snapshot";
+    if (header.format != snapshot_format_version)
+        return "unsupported snapshot format";
+    if (header.version != version)
+        return "snapshot version mismatch";
+    if (header.size != size - sizeof(header))
+        return "truncated snapshot";
+    if (header.checksum !=
+        snapshot_checksum(data + sizeof(header), header.size))
+        return "corrupted snapshot";
+    return nullptr;
+}
+
+class snapshot_reader
+{
+    const char* data_;
+    std::size_t size_;
+    std::size_t pos_ = sizeof(snapshot_header);
+
+public:
+    snapshot_reader(const char* data, std::size_t size, std::uint32_t version)
+        : data_{data}
+        , size_{size}
+    {
+        if (auto error = check_snapshot(data, size, version))
+            LAGER_THROW(snapshot_error{error});
+    }
+
+    std::size_t remaining() const { return size_ - pos_; }
+
+    const char* read_bytes(std::size_t size)
+    {
+        if (size > remaining())
+            LAGER_THROW(snapshot_error{"corrupted snapshot"});
+        auto p = data_ + pos_;
+        pos_ += size;
+        return p;
+    }
+
+    template <typename T>
+    void read(T& value)
+    {
+        std::memcpy(&value, read_bytes(sizeof(T)), sizeof(T));
+    }
+
+    void align(std::size_t alignment)
+    {
+        read_bytes((alignment - pos_ % alignment) % alignment);
+    }
+
+    void finish() const
+    {
+        if (remaining())
+            LAGER_THROW(snapshot_error{"corrupted snapshot"});
+    }
+};
+
+// Values that are written as their bytes, and sequences of which are
+// materialized directly from the mapped memory.
+template <typename T>
+constexpr bool is_snapshot_blittable =
+    std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+    (std::is_trivially_copyable_v<T> &&
+     std::has_unique_object_representations_v<T>);
+
+template <typename T>
+struct is_snapshot_optional : std::false_type
+{};
+
+template <typename T>
+struct is_snapshot_optional<std::optional<T>> : std::true_type
+{};
+
+template <typename T>
+struct is_snapshot_variant : std::false_type
+{};
+
+template <typename... Ts>
+struct is_snapshot_variant<std::variant<Ts...>> : std::true_type
+{};
+
+template <typename T>
+struct is_snapshot_pair : std::false_type
+{};
+
+template <typename T, typename U>
+struct is_snapshot_pair<std::pair<T, U>> : std::true_type
+{};
+
+template <typename T>
+using snapshot_begin_t = decltype(std::declval<const T&>().begin());
+
+template <typename T>
+using snapshot_key_t = typename T::key_type;
+
+template <typename T>
+using snapshot_key_equal_t = typename T::key_equal;
+
+// Maps and sets, immer sets only define `key_equal`.
+template <typename T>
+constexpr bool is_snapshot_associative =
+    zug::meta::is_detected<snapshot_key_t, T>::value ||
+    zug::meta::is_detected<snapshot_key_equal_t, T>::value;
+
+template <typename T>
+using snapshot_box_t = std::enable_if_t<
+    std::is_same_v<decltype(std::declval<const T&>().get()),
+                   const typename T::value_type&> &&
+    std::is_constructible_v<T, typename T::value_type>>;
+
+template <typename T>
+using snapshot_persistent_insert_t = std::enable_if_t<std::is_same_v<
+    decltype(std::declval<T>().insert(std::declval<typename T::value_type>())),
+    T>>;
+
+// The elements of associative containers, without the constness of the keys
+// of the standard maps.
+template <typename T>
+struct snapshot_element
+{
+    using type = T;
+};
+
+template <typename K, typename V>
+struct snapshot_element<std::pair<const K, V>>
+{
+    using type = std::pair<K, V>;
+};
+
+template <typename T>
+using snapshot_element_t = typename snapshot_element<T>::type;
+
+template <typename T>
+void save_snapshot_value(snapshot_writer& w, const T& x);
+
+template <typename T>
+void load_snapshot_value(snapshot_reader& r, T& x);
+
+template <typename T>
+void save_snapshot_size(snapshot_writer& w, const T& x)
+{
+    w.write(static_cast<std::uint64_t>(x.size()));
+}
+
+inline std::size_t load_snapshot_size(snapshot_reader& r)
+{
+    auto size = std::uint64_t{};
+    r.read(size);
+    if (size > r.remaining())
+        LAGER_THROW(snapshot_error{"corrupted snapshot"});
+    return static_cast<std::size_t>(size);
+}
+
+template <typename T, std::size_t... Is>
+void load_snapshot_alternative(snapshot_reader& r,
+                               T& x,
+                               std::size_t index,
+                               std::index_sequence<Is...>)
+{
+    auto loaded = ((index == Is ? (load_snapshot_value(
+                                       r, x.template emplace<Is>()),
+                                   true)
+                                : false) ||
+                   ...);
+    if (!loaded)
+        LAGER_THROW(snapshot_error{"corrupted snapshot"});
+}
+
+template <typename T>
+void save_snapshot_value(snapshot_writer& w, const T& x)
+{
+    if constexpr (is_snapshot_blittable<T>) {
+        w.write(x);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        save_snapshot_size(w, x);
+        w.write_bytes(x.data(), x.size());
+    } else if constexpr (is_snapshot_optional<T>::value) {
+        w.write(static_cast<std::uint8_t>(x.has_value()));
+        if (x)
+            save_snapshot_value(w, *x);
+    } else if constexpr (is_snapshot_variant<T>::value) {
+        w.write(static_cast<std::uint32_t>(x.index()));
+        std::visit([&](auto&& v) { save_snapshot_value(w, v); }, x);
+    } else if constexpr (is_snapshot_pair<T>::value) {
+        save_snapshot_value(w, x.first);
+        save_snapshot_value(w, x.second);
+    } else if constexpr (boost::hana::Struct<T>::value) {
+        boost::hana::for_each(boost::hana::accessors<T>(), [&](auto&& acc) {
+            save_snapshot_value(w, boost::hana::second(acc)(x));
+        });
+    } else if constexpr (zug::meta::is_detected<snapshot_box_t, T>::value) {
+        save_snapshot_value(w, x.get());
+    } else if constexpr (is_snapshot_associative<T>) {
+        // associative containers are rebuilt one element at a time, so they
+        // are never stored as arrays
+        save_snapshot_size(w, x);
+        for (const auto& v : x)
+            save_snapshot_value(w, v);
+    } else if constexpr (zug::meta::is_detected<snapshot_begin_t, T>::value) {
+        using value_t = typename T::value_type;
+        save_snapshot_size(w, x);
+        if constexpr (is_snapshot_blittable<value_t>) {
+            w.align(alignof(value_t));
+            auto p = w.grow(x.size() * sizeof(value_t));
+            for (const value_t& v : x) {
+                std::memcpy(p, &v, sizeof(value_t));
+                p += sizeof(value_t);
+            }
+        } else {
+            for (const auto& v : x)
+                save_snapshot_value(w, v);
+        }
+    } else {
+        static_assert(!std::is_same_v<T, T>,
+                      "this type can not be stored in a snapshot");
+    }
+}
+
+template <typename T>
+void load_snapshot_value(snapshot_reader& r, T& x)
+{
+    if constexpr (is_snapshot_blittable<T>) {
+        r.read(x);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        auto size = load_snapshot_size(r);
+        x.assign(r.read_bytes(size), size);
+    } else if constexpr (is_snapshot_optional<T>::value) {
+        auto engaged = std::uint8_t{};
+        r.read(engaged);
+        if (engaged)
+            load_snapshot_value(r, x.emplace());
+        else
+            x.reset();
+    } else if constexpr (is_snapshot_variant<T>::value) {
+        auto index = std::uint32_t{};
+        r.read(index);
+        load_snapshot_alternative(
+            r, x, index, std::make_index_sequence<std::variant_size_v<T>>{});
+    } else if constexpr (is_snapshot_pair<T>::value) {
+        load_snapshot_value(r, x.first);
+        load_snapshot_value(r, x.second);
+    } else if constexpr (boost::hana::Struct<T>::value) {
+        boost::hana::for_each(boost::hana::accessors<T>(), [&](auto&& acc) {
+            load_snapshot_value(r, boost::hana::second(acc)(x));
+        });
+    } else if constexpr (zug::meta::is_detected<snapshot_box_t, T>::value) {
+        auto v = typename T::value_type{};
+        load_snapshot_value(r, v);
+        x = T{std::move(v)};
+    } else if constexpr (is_snapshot_associative<T>) {
+        auto size = load_snapshot_size(r);
+        x         = T{};
+        for (auto i = std::size_t{}; i < size; ++i) {
+            auto v = snapshot_element_t<typename T::value_type>{};
+            load_snapshot_value(r, v);
+            if constexpr (zug::meta::is_detected<snapshot_persistent_insert_t,
+                                                 T>::value)
+                x = std::move(x).insert(std::move(v));
+            else
+                x.insert(std::move(v));
+        }
+    } else if constexpr (zug::meta::is_detected<snapshot_begin_t, T>::value) {
+        using value_t = typename T::value_type;
+        auto size     = load_snapshot_size(r);
+        if constexpr (is_snapshot_blittable<value_t>) {
+            r.align(alignof(value_t));
+            if (size > r.remaining() / sizeof(value_t))
+                LAGER_THROW(snapshot_error{"corrupted snapshot"});
+            auto p = r.read_bytes(size * sizeof(value_t));
+            if (reinterpret_cast<std::uintptr_t>(p) % alignof(value_t) == 0) {
+                auto first = reinterpret_cast<const value_t*>(p);
+                x          = T(first, first + size);
+            } else {
+                auto v = std::make_unique<value_t[]>(size);
+                std::memcpy(v.get(), p, size * sizeof(value_t));
+                x = T(v.get(), v.get() + size);
+            }
+        } else {
+            auto v = std::vector<value_t>(size);
+            for (auto& e : v)
+                load_snapshot_value(r, e);
+            x = T(std::make_move_iterator(v.begin()),
+                  std::make_move_iterator(v.end()));
+        }
+    } else {
+        static_assert(!std::is_same_v<T, T>,
+                      "this type can not be loaded from a snapshot");
+    }
+}
+
+#if LAGER_SNAPSHOT_USE_FSYNC
+// Writes `data` to `fname` and waits until it reaches the disk.
+inline bool write_synced_file(const std::string& fname,
+                              const std::vector<char>& data)
+{
+    auto fd = ::open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+    auto p    = data.data();
+    auto left = data.size();
+    while (left > 0) {
+        auto n = ::write(fd, p, left);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0) {
+            ::close(fd);
+            return false;
+        }
+        p += n;
+        left -= static_cast<std::size_t>(n);
+    }
+    auto synced = ::fsync(fd) == 0;
+    return ::close(fd) == 0 && synced;
+}
+
+// Makes the renames in the directory of `fname` durable.
+inline void sync_parent_directory(const std::string& fname)
+{
+    auto slash = fname.find_last_of('/');
+    auto dir   = slash == std::string::npos ? std::string{"."}
+                                            : fname.substr(0, slash + 1);
+    auto fd    = ::open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+#endif
+
+// Writes to a temporary file that then replaces `fname`.  Where it is
+// supported, the temporary file is synced to the disk before the rename, so
+// that the rename can not reach the disk before its contents.
+inline void write_snapshot_file(const std::string& fname,
+                                const std::vector<char>& data)
+{
+    auto temp = fname + ".tmp";
+#if LAGER_SNAPSHOT_USE_FSYNC
+    if (!write_synced_file(temp, data))
+        LAGER_THROW(snapshot_error{"could not write snapshot: " + temp});
+#else
+    {
+        auto os = std::ofstream{temp, std::ios::binary | std::ios::trunc};
+        os.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!os.flush())
+            LAGER_THROW(snapshot_error{"could not write snapshot: " + temp});
+    }
+#endif
+    if (std::rename(temp.c_str(), fname.c_str()))
+        LAGER_THROW(snapshot_error{"could not write snapshot: " + fname});
+#if LAGER_SNAPSHOT_USE_FSYNC
+    sync_parent_directory(fname);
+#endif
+}
+
+// The contents of a file, mapped in memory when the platform supports it.
+class snapshot_file
+{
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+#if LAGER_SNAPSHOT_USE_MMAP
+    void* map_ = nullptr;
+#else
+    std::vector<char> buffer_;
+#endif
+
+public:
+    snapshot_file(const std::string& fname)
+    {
+#if LAGER_SNAPSHOT_USE_MMAP
+        auto fd = ::open(fname.c_str(), O_RDONLY);
+        if (fd < 0)
+            LAGER_THROW(snapshot_error{"could not open snapshot: " + fname});
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            size_ = static_cast<std::size_t>(st.st_size);
+            map_  = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (map_ == MAP_FAILED || !map_) {
+            map_ = nullptr;
+            LAGER_THROW(snapshot_error{"could not map snapshot: " + fname});
+        }
+        data_ = static_cast<const char*>(map_);
+#else
+        auto is = std::ifstream{fname, std::ios::binary};
+        if (!is)
+            LAGER_THROW(snapshot_error{"could not open snapshot: " + fname});
+        buffer_.assign(std::istreambuf_iterator<char>{is},
+                       std::istreambuf_iterator<char>{});
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    snapshot_file(const snapshot_file&) = delete;
+    snapshot_file& operator=(const snapshot_file&) = delete;
+
+    ~snapshot_file()
+    {
+#if LAGER_SNAPSHOT_USE_MMAP
+        if (map_)
+            ::munmap(map_, size_);
+#endif
+    }
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+};
+
+} // namespace detail
+
+//! @addtogroup snapshots
+//! @{
+
+/*!
+ * Returns a snapshot of `value`, a compact binary representation of it that
+ * can be restored quickly with `read_snapshot()`.
+ *
+ * Snapshots support arithmetic types, enums, strings, optionals, variants,
+ * pairs, structs defined with `LAGER_STRUCT`, boxes and standard or immer
+ * containers of those.  Sequences of trivially copyable values are stored as
+ * aligned arrays that are materialized directly from the snapshot memory.
+ * The values are written in the native representation of the machine, so
+ * snapshots are meant as a fast local cache of the model, not as a
+ * portable exchange format.
+ *
+ * The snapshot is tagged with the `version` of the model, which must match
+ * the one passed when reading it.
+ */
+template <typename T>
+std::vector<char> make_snapshot(const T& value, std::uint32_t version = 0)
+{
+    auto w = detail::snapshot_writer{};
+    detail::save_snapshot_value(w, value);
+    return std::move(w).finish(version);
+}
+
+/*!
+ * Restores a value from the snapshot in `data`.  Raises `snapshot_error` when
+ * it is corrupted or was written for another `version`.
+ */
+template <typename T>
+T read_snapshot(const char* data, std::size_t size, std::uint32_t version = 0)
+{
+    auto r      = detail::snapshot_reader{data, size, version};
+    auto result = T{};
+    detail::load_snapshot_value(r, result);
+    r.finish();
+    return result;
+}
+
+/*!
+ * Writes a snapshot of `value` to the file `fname`.  The snapshot is written
+ * to a temporary file first, that replaces `fname` when complete.  On POSIX
+ * systems the temporary file is synced to the disk before replacing `fname`,
+ * so neither a crash nor a power loss leave a truncated snapshot behind.
+ * Elsewhere, only a crash of the program is guaranteed not to.
+ */
+template <typename T>
+void save_snapshot(const std::string& fname,
+                   const T& value,
+                   std::uint32_t version = 0)
+{
+    detail::write_snapshot_file(fname, make_snapshot(value, version));
+}
+
+/*!
+ * Restores a value from the snapshot file `fname`.  The file is mapped in
+ * memory, so restoring does not need to read it in advance and large arrays
+ * are copied straight from the page cache.
+ */
+template <typename T>
+T load_snapshot(const std::string& fname, std::uint32_t version = 0)
+{
+    auto file = detail::snapshot_file{fname};
+    return read_snapshot<T>(file.data(), file.size(), version);
+}
+
+//! @}
+
+} // namespace lager
@@ -0,0 +1,185 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/access.hpp>
+#include <lager/detail/lru_cache.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace lager {
+
+namespace detail {
+
+struct intern_hash
+{
+    template <typename T>
+    std::size_t operator()(const T& x) const
+    {
+        if constexpr (std::is_member_pointer_v<T>) {
+            // there is no std::hash for pointers to members
+            auto bytes = std::string_view{
+                reinterpret_cast<const char*>(&x), sizeof(x)};
+            return std::hash<std::string_view>{}(bytes);
+        } else {
+            return memo_hash{}(x);
+        }
+    }
+};
+
+template <typename Key>
+struct intern_key
+{
+    const void* parent;
+    Key key;
+
+    bool operator==(const intern_key& other) const
+    {
+        return parent == other.parent && key == other.key;
+    }
+};
+
+template <typename Key>
+struct intern_key_hash
+{
+    std::size_t operator()(const intern_key<Key>& x) const
+    {
+        return memo_hash{}(std::make_tuple(x.parent, intern_hash{}(x.key)));
+    }
+};
+
+/*!
+ * Weak references to the interned nodes of type `Node`, derived with keys of
+ * type `Key`.  There is one table per combination of types, shared by the
+ * whole program.
+ */
+template <typename Node, typename Key>
+class intern_table
+{
+    using map_t = std::unordered_map<intern_key<Key>,
+                                     std::weak_ptr<Node>,
+                                     intern_key_hash<Key>>;
+
+    std::mutex mutex_;
+    map_t entries_;
+    std::size_t next_collect_ = 16;
+
+    void collect_()
+    {
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (it->second.expired())
+                it = entries_.erase(it);
+            else
+                ++it;
+        }
+        next_collect_ = std::max(std::size_t{16}, 2 * entries_.size());
+    }
+
+public:
+    static intern_table& instance()
+    {
+        static auto table = intern_table{};
+        return table;
+    }
+
+    template <typename Make>
+    std::shared_ptr<Node> get(const void* parent, Key key, Make&& make)
+    {
+        auto lock = std::lock_guard<std::mutex>{mutex_};
+        auto& ref = entries_[{parent, std::move(key)}];
+        if (auto node = ref.lock())
+            return node;
+        auto node = std::invoke(std::forward<Make>(make));
+        ref       = node;
+        if (entries_.size() >= next_collect_)
+            collect_();
+        return node;
+    }
+};
+
+template <typename Parent, typename Key, typename Make>
+auto intern_node(const Parent& parent, Key&& key, Make&& make)
+{
+    using result_t = std::decay_t<std::invoke_result_t<Make>>;
+    using node_t   = node_type_t<result_t>;
+    using table_t  = intern_table<node_t, std::decay_t<Key>>;
+    // The same node may be reached through pointers to different bases.
+    auto parent_id = dynamic_cast<const void*>(access::node(parent).get());
+    return result_t{table_t::instance().get(
+        parent_id, std::forward<Key>(key), [&] {
+            return access::node(std::invoke(std::forward<Make>(make)));
+        })};
+}
+
+} // namespace detail
+
+//! @defgroup cursors
+//! @{
+
+/*!
+ * Like `parent[key]`, but returns a cursor to the same node that a previous
+ * call with the same `parent` and `key` returned, as long as it is still
+ * alive.  This avoids duplicate nodes, each holding a copy of the same value
+ * and recomputing it on every change, when many independent components derive
+ * the same cursor.
+ *
+ * The interned nodes are only weakly referenced, so they are released with
+ * the last cursor that uses them.  The keys must be equality comparable and
+ * hashable with `std::hash` or be pointers to members.
+ */
+template <typename Parent, typename Key>
+auto intern(const Parent& parent, Key key)
+{
+    return detail::intern_node(
+        parent, key, [&] { return parent[key].make(); });
+}
+
+/*!
+ * Like `parent.zoom(lens)`, but reusing the node of previous calls with the
+ * same `parent` and `key`.  Lenses can not be compared, so `key` must
+ * identify `lens` among all the lenses of its type that are used to zoom into
+ * `parent`.  @see `intern`
+ */
+template <typename Parent, typename Key, typename Lens>
+auto intern_zoom(const Parent& parent, Key key, Lens&& lens)
+{
+    return detail::intern_node(parent, std::move(key), [&] {
+        return parent.zoom(std::forward<Lens>(lens)).make();
+    });
+}
+
+/*!
+ * Like `parent.xform(xform)`, but reusing the node of previous calls with the
+ * same `parent` and `key`.  Transducers can not be compared, so `key` must
+ * identify `xform` among all the transducers of its type that are used to
+ * transform `parent`.  @see `intern`
+ */
+template <typename Parent, typename Key, typename Xform>
+auto intern_xform(const Parent& parent, Key key, Xform&& xform)
+{
+    return detail::intern_node(parent, std::move(key), [&] {
+        return parent.xform(std::forward<Xform>(xform)).make();
+    });
+}
+
+//! @}
+
+} // namespace lager
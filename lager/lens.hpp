@@ -1,7 +1,9 @@
 #pragma once
 
 #include <lager/lenses.hpp>
+#include <cstddef>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -14,10 +16,16 @@ struct lens_i
     virtual ~lens_i()                                  = default;
     virtual Part view(Whole const&) const              = 0;
     virtual Whole set(Whole const&, Part const&) const = 0;
+    virtual Whole set(Whole&&, Part&&) const           = 0;
+
+    //! Constructs a copy of the object in the uninitialized `buffer`.
+    virtual lens_i* copy_to(void* buffer) const = 0;
+    //! Move constructs the object in the uninitialized `buffer`.
+    virtual lens_i* move_to(void* buffer) noexcept = 0;
 };
 
 template <typename Lens, typename Whole, typename Part>
-struct lens_holder : public lens_i<Whole, Part>
+struct lens_holder final : public lens_i<Whole, Part>
 {
     Lens value;
 
@@ -32,6 +40,21 @@ struct lens_holder : public lens_i<Whole, Part>
     {
         return ::lager::set(value, w, p);
     }
+
+    Whole set(Whole&& w, Part&& p) const override
+    {
+        return ::lager::set(value, std::move(w), std::move(p));
+    }
+
+    lens_i<Whole, Part>* copy_to(void* buffer) const override
+    {
+        return new (buffer) lens_holder{value};
+    }
+
+    lens_i<Whole, Part>* move_to(void* buffer) noexcept override
+    {
+        return new (buffer) lens_holder{std::move(value)};
+    }
 };
 
 } // namespace detail
@@ -39,10 +62,34 @@ struct lens_holder : public lens_i<Whole, Part>
 //! @defgroup lenses-api
 //! @{
 
+/*!
+ * A lens from `Whole` to `Part` of any type.  Small lenses, like most
+ * compositions of `attr` and `at`, are stored inline, others are allocated
+ * in the heap and shared among copies.
+ *
+ * `view()`, `set()` and `over()` call the lens directly, without going
+ * through the functor machinery of the lens, and `set()` and `over()` move
+ * the whole when it is an rvalue.
+ */
 template <typename Whole, typename Part>
 class lens : zug::detail::pipeable
 {
-    std::shared_ptr<detail::lens_i<Whole, Part> const> holder_;
+    using interface_t = detail::lens_i<Whole, Part>;
+
+    template <typename Lens>
+    using holder_t = detail::lens_holder<std::decay_t<Lens>, Whole, Part>;
+
+    static constexpr auto buffer_size = 6 * sizeof(void*);
+
+    template <typename Holder>
+    static constexpr bool fits_inline =
+        sizeof(Holder) <= buffer_size &&
+        alignof(Holder) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<Holder>;
+
+    alignas(std::max_align_t) unsigned char buffer_[buffer_size];
+    interface_t* impl_ = nullptr;
+    std::shared_ptr<interface_t> shared_;
 
 public:
     template <typename Lens,
@@ -50,23 +97,114 @@ public:
                   !std::is_same_v<std::decay_t<Lens>, std::decay_t<lens>>,
                   int>::type = 0>
     lens(Lens&& lens)
-        : holder_{new detail::lens_holder<std::decay_t<Lens>, Whole, Part>{
-              std::forward<Lens>(lens)}}
-    {}
+    {
+        if constexpr (fits_inline<holder_t<Lens>>) {
+            impl_ = new (buffer_) holder_t<Lens>{std::forward<Lens>(lens)};
+        } else {
+            shared_ = std::make_shared<holder_t<Lens>>(std::forward<Lens>(lens));
+            impl_   = shared_.get();
+        }
+    }
+
+    lens(const lens& other) { assign_(other); }
+    lens(lens&& other) noexcept { assign_(std::move(other)); }
+
+    lens& operator=(const lens& other)
+    {
+        if (this != &other) {
+            reset_();
+            assign_(other);
+        }
+        return *this;
+    }
+
+    lens& operator=(lens&& other) noexcept
+    {
+        if (this != &other) {
+            reset_();
+            assign_(std::move(other));
+        }
+        return *this;
+    }
+
+    ~lens() { reset_(); }
 
     template <typename F>
     auto operator()(F&& f) const
     {
         return [this, f = std::forward<F>(f)](auto&& p) {
-            return f(holder_->view(std::forward<decltype(p)>(p)))(
+            return f(impl_->view(std::forward<decltype(p)>(p)))(
                 [&](auto&& x) {
-                    return holder_->set(std::forward<decltype(p)>(p),
-                                        std::forward<decltype(x)>(x));
+                    return impl_->set(std::forward<decltype(p)>(p),
+                                      std::forward<decltype(x)>(x));
                 });
         };
     }
+
+    Part view(const Whole& w) const { return impl_->view(w); }
+
+    Whole set(const Whole& w, const Part& p) const { return impl_->set(w, p); }
+    Whole set(const Whole& w, Part&& p) const { return impl_->set(w, p); }
+    Whole set(Whole&& w, const Part& p) const
+    {
+        return impl_->set(std::move(w), Part{p});
+    }
+    Whole set(Whole&& w, Part&& p) const
+    {
+        return impl_->set(std::move(w), std::move(p));
+    }
+
+    template <typename Fn>
+    Whole over(const Whole& w, Fn&& fn) const
+    {
+        return set(w, std::forward<Fn>(fn)(impl_->view(w)));
+    }
+    template <typename Fn>
+    Whole over(Whole&& w, Fn&& fn) const
+    {
+        auto&& p = std::forward<Fn>(fn)(impl_->view(w));
+        return set(std::move(w), std::forward<decltype(p)>(p));
+    }
+
+private:
+    void assign_(const lens& other)
+    {
+        if (other.shared_) {
+            shared_ = other.shared_;
+            impl_   = shared_.get();
+        } else if (other.impl_) {
+            impl_ = other.impl_->copy_to(buffer_);
+        }
+    }
+
+    void assign_(lens&& other) noexcept
+    {
+        if (other.shared_) {
+            shared_     = std::move(other.shared_);
+            impl_       = shared_.get();
+            other.impl_ = nullptr;
+        } else if (other.impl_) {
+            impl_ = other.impl_->move_to(buffer_);
+        }
+    }
+
+    void reset_()
+    {
+        if (!shared_ && impl_)
+            impl_->~interface_t();
+        shared_.reset();
+        impl_ = nullptr;
+    }
 };
 
 //! @}
 
+namespace detail {
+
+template <typename Whole, typename Part>
+struct is_erased_lens<lens<Whole, Part>> : std::true_type
+{};
+
+} // namespace detail
+
 } // namespace lager
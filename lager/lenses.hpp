@@ -63,6 +63,31 @@ struct identity_functor
             std::forward<Fn>(f)(std::forward<T>(value)));
     }
 };
+
+//! Whether `T` is the functor used by `set()` and `over()`, which lenses can
+//! use to update the whole in place of viewing it first.
+template <typename T>
+struct is_identity_functor : std::false_type
+{};
+
+template <typename T>
+struct is_identity_functor<identity_functor<T>> : std::true_type
+{};
+
+//! Whether `T` is the functor used by `view()`.
+template <typename T>
+struct is_const_functor : std::false_type
+{};
+
+template <typename T>
+struct is_const_functor<const_functor<T>> : std::true_type
+{};
+
+//! Whether `T` is a `lager::lens`, which can be called directly.
+template <typename T>
+struct is_erased_lens : std::false_type
+{};
+
 } // namespace detail
 
 //! @defgroup lenses-api
@@ -71,28 +96,38 @@ struct identity_functor
 template <typename LensT, typename T>
 decltype(auto) view(LensT&& lens, T&& x)
 {
-    return lens([](auto&& v) {
-               return detail::make_const_functor(std::forward<decltype(v)>(v));
-           })(std::forward<T>(x))
-        .value;
+    if constexpr (detail::is_erased_lens<std::decay_t<LensT>>::value)
+        return lens.view(std::forward<T>(x));
+    else
+        return lens([](auto&& v) {
+                   return detail::make_const_functor(
+                       std::forward<decltype(v)>(v));
+               })(std::forward<T>(x))
+            .value;
 }
 
 template <typename LensT, typename T, typename U>
 decltype(auto) set(LensT&& lens, T&& x, U&& v)
 {
-    return lens([&v](auto&&) { return detail::make_identity_functor(v); })(
-               std::forward<T>(x))
-        .value;
+    if constexpr (detail::is_erased_lens<std::decay_t<LensT>>::value)
+        return lens.set(std::forward<T>(x), std::forward<U>(v));
+    else
+        return lens([&v](auto&&) { return detail::make_identity_functor(v); })(
+                   std::forward<T>(x))
+            .value;
 }
 
 template <typename LensT, typename T, typename Fn>
 decltype(auto) over(LensT&& lens, T&& x, Fn&& fn)
 {
-    return lens([&fn](auto&& v) {
-               auto u = fn(std::forward<decltype(v)>(v));
-               return detail::make_identity_functor(std::move(u));
-           })(std::forward<T>(x))
-        .value;
+    if constexpr (detail::is_erased_lens<std::decay_t<LensT>>::value)
+        return lens.over(std::forward<T>(x), std::forward<Fn>(fn));
+    else
+        return lens([&fn](auto&& v) {
+                   auto u = fn(std::forward<decltype(v)>(v));
+                   return detail::make_identity_functor(std::move(u));
+               })(std::forward<T>(x))
+            .value;
 }
 
 //! @}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <lager/config.hpp>
+#include <lager/lenses.hpp>
 #include <lager/util.hpp>
 
 #include <zug/compose.hpp>
@@ -19,6 +20,11 @@ template <typename T, typename Key, typename OptValue>
 using set_opt_t = std::decay_t<decltype(std::declval<T>().set(
     std::declval<Key>(), std::declval<OptValue>().value()))>;
 
+// detect if T satifsies the immer API for setting values
+template <typename T, typename Key, typename V>
+using set_t = std::decay_t<decltype(std::declval<T>().set(std::declval<Key>(),
+                                                          std::declval<V>()))>;
+
 // detect if T satisfies the immer API for inserting values
 template <typename T, typename OptValue>
 using insert_opt_t = std::decay_t<decltype(std::declval<T>().insert(
@@ -27,14 +33,26 @@ using insert_opt_t = std::decay_t<decltype(std::declval<T>().insert(
 template <typename T, typename K>
 using has_count_t = decltype(std::declval<T>().count(std::declval<K>()));
 
-// When building without exception support, returns whether the container has
-// the key, using some heuristics to distinguish vector-likes or map-like
-// containers.  Otherwise it just returns true and we use the normal
-// exception-based mechanism.
+// a function object type to detect the immer API for updating values
+struct update_fn_probe
+{
+    template <typename T>
+    T operator()(T&& x) const;
+};
+
+template <typename T, typename Key>
+using update_t = decltype(std::declval<T>().update(
+    std::declval<Key>(), std::declval<update_fn_probe>()));
+
+template <typename T, typename Key>
+using update_if_exists_t = decltype(std::declval<T>().update_if_exists(
+    std::declval<Key>(), std::declval<update_fn_probe>()));
+
+// Returns whether the container has the key, using some heuristics to
+// distinguish vector-likes or map-like containers.
 template <typename Whole, typename Key>
-bool maybe_has_key(const Whole& whole, const Key& k) noexcept
+bool has_key(const Whole& whole, const Key& k) noexcept
 {
-#ifdef LAGER_NO_EXCEPTIONS
     if constexpr (zug::meta::is_detected<has_count_t, Whole, Key>::value) {
         return whole.count(k) > 0;
     } else if constexpr (std::is_convertible<Key, typename Whole::size_type>::
@@ -48,11 +66,65 @@ bool maybe_has_key(const Whole& whole, const Key& k) noexcept
             "at lense not supported with LAGER_NO_EXCEPTIONS");
         return true;
     }
+}
+
+// When building without exception support, returns whether the container has
+// the key.  Otherwise it just returns true and we use the normal
+// exception-based mechanism.
+template <typename Whole, typename Key>
+bool maybe_has_key(const Whole& whole, const Key& k) noexcept
+{
+#ifdef LAGER_NO_EXCEPTIONS
+    return has_key(whole, k);
 #else
     return true;
 #endif
 }
 
+// Whether the element at a key of a `Whole` can be replaced with a single
+// lookup, using `update_if_exists()` on map-likes or `update()` on
+// vector-likes after checking the bounds.  Containers that also `insert()`,
+// like tables, are excluded: setting them may not keep the key.
+template <typename Whole, typename Key>
+constexpr bool can_update_at()
+{
+    using value_t =
+        std::decay_t<decltype(std::declval<Whole>().at(std::declval<Key>()))>;
+    if constexpr (zug::meta::is_detected<insert_opt_t,
+                                         Whole,
+                                         std::optional<value_t>>::value) {
+        return false;
+    } else if constexpr (zug::meta::is_detected<update_if_exists_t,
+                                                Whole,
+                                                Key>::value) {
+        return true;
+    } else if constexpr (zug::meta::is_detected<update_t, Whole, Key>::value &&
+                         !zug::meta::is_detected<has_count_t, Whole, Key>::
+                             value) {
+        return std::is_convertible<Key, typename Whole::size_type>::value;
+    } else {
+        return false;
+    }
+}
+
+// Replaces the element at `key` with the result of calling `fn` with it, or
+// returns the whole unchanged when there is no such element.
+template <typename Whole, typename Key, typename Fn>
+std::decay_t<Whole> at_update_impl(Whole&& whole, const Key& key, Fn&& fn)
+{
+    using whole_t = std::decay_t<Whole>;
+    if constexpr (zug::meta::is_detected<update_if_exists_t, whole_t, Key>::
+                      value) {
+        return std::forward<Whole>(whole).update_if_exists(
+            key, std::forward<Fn>(fn));
+    } else {
+        const auto k = static_cast<typename whole_t::size_type>(key);
+        if (k >= whole.size())
+            return std::forward<Whole>(whole);
+        return std::forward<Whole>(whole).update(k, std::forward<Fn>(fn));
+    }
+}
+
 template <typename Whole,
           typename Part,
           typename Key,
@@ -112,6 +184,24 @@ std::decay_t<Whole> at_setter_impl(Whole&& whole, Part&& part, Key&& key)
     return std::forward<Whole>(whole);
 }
 
+template <typename Whole, typename Part, typename Key>
+std::decay_t<Whole>
+at_unchecked_setter_impl(Whole&& whole, Part&& part, const Key& key)
+{
+    using whole_t = std::decay_t<Whole>;
+    using opt_t   = std::optional<std::decay_t<Part>>;
+    if constexpr (zug::meta::is_detected<insert_opt_t, whole_t, opt_t>::value) {
+        return std::forward<Whole>(whole).insert(std::forward<Part>(part));
+    } else if constexpr (zug::meta::is_detected<set_t, whole_t, Key, Part>::
+                             value) {
+        return std::forward<Whole>(whole).set(key, std::forward<Part>(part));
+    } else {
+        auto r    = std::forward<Whole>(whole);
+        r.at(key) = std::forward<Part>(part);
+        return r;
+    }
+}
+
 } // namespace detail
 
 //! @defgroup lenses
@@ -119,22 +209,81 @@ std::decay_t<Whole> at_setter_impl(Whole&& whole, Part&& part, Key&& key)
 
 /*!
  * `Key -> Lens<{X}, [X]>`
+ *
+ * When setting or updating the element of an immer container, it is looked
+ * up only once.
  */
 template <typename Key>
 auto at(Key key)
 {
     return zug::comp([key](auto&& f) {
         return [f = LAGER_FWD(f), &key](auto&& whole) {
-            using Part = std::optional<std::decay_t<decltype(whole.at(key))>>;
-            return f([&]() -> Part {
-                if (!detail::maybe_has_key(whole, key))
-                    return std::nullopt;
-                LAGER_TRY { return LAGER_FWD(whole).at(key); }
-                LAGER_CATCH(std::out_of_range const&) { return std::nullopt; }
-            }())([&](Part part) {
-                return detail::at_setter_impl(
-                    LAGER_FWD(whole), std::move(part), key);
-            });
+            using Whole = std::decay_t<decltype(whole)>;
+            using Part  = std::optional<std::decay_t<decltype(whole.at(key))>>;
+            using functor_t = std::decay_t<decltype(f(std::declval<Part>()))>;
+            if constexpr (detail::can_update_at<Whole, Key>() &&
+                          ::lager::detail::is_identity_functor<
+                              functor_t>::value) {
+                return ::lager::detail::make_identity_functor(
+                    detail::at_update_impl(
+                        LAGER_FWD(whole), key, [&](const auto& x) {
+                            Part part = f(Part{x}).value;
+                            return part ? *std::move(part) : x;
+                        }));
+            } else {
+                return f([&]() -> Part {
+                    if (!detail::maybe_has_key(whole, key))
+                        return std::nullopt;
+                    LAGER_TRY { return LAGER_FWD(whole).at(key); }
+                    LAGER_CATCH(std::out_of_range const&)
+                    {
+                        return std::nullopt;
+                    }
+                }())([&](Part part) {
+                    return detail::at_setter_impl(
+                        LAGER_FWD(whole), std::move(part), key);
+                });
+            }
+        };
+    });
+}
+
+/*!
+ * `Key -> Lens<{X}, X>`
+ *
+ * Like `at`, but focuses the element itself instead of an optional, so it is
+ * viewed without copying it.  The key must be in the container: viewing,
+ * setting or updating a missing key throws `std::out_of_range` for every
+ * kind of container, or aborts when building with `LAGER_NO_EXCEPTIONS`.
+ */
+template <typename Key>
+auto at_unchecked(Key key)
+{
+    return zug::comp([key](auto&& f) {
+        return [f = LAGER_FWD(f), &key](auto&& whole) {
+            using Whole = std::decay_t<decltype(whole)>;
+            using Part  = std::decay_t<decltype(whole.at(key))>;
+            using functor_t =
+                std::decay_t<decltype(f(std::declval<const Part&>()))>;
+            if constexpr (detail::can_update_at<Whole, Key>() &&
+                          ::lager::detail::is_identity_functor<
+                              functor_t>::value) {
+                auto found  = false;
+                auto result = detail::at_update_impl(
+                    LAGER_FWD(whole), key, [&](const Part& x) -> Part {
+                        found = true;
+                        return f(x).value;
+                    });
+                if (!found)
+                    LAGER_THROW(std::out_of_range{"at_unchecked: no key"});
+                return ::lager::detail::make_identity_functor(
+                    std::move(result));
+            } else {
+                return f(LAGER_FWD(whole).at(key))([&](auto&& part) {
+                    return detail::at_unchecked_setter_impl(
+                        LAGER_FWD(whole), LAGER_FWD(part), key);
+                });
+            }
         };
     });
 }
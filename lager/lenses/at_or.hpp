@@ -9,17 +9,13 @@
 #include <zug/meta/detected.hpp>
 
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace lager {
 namespace lenses {
 namespace detail {
 
-// detect if T satifsies the immer API for setting values
-template <typename T, typename Key, typename V>
-using set_t = std::decay_t<decltype(std::declval<T>().set(std::declval<Key>(),
-                                                          std::declval<V>()))>;
-
 template <
     typename Whole,
     typename Part,
@@ -56,22 +52,68 @@ std::decay_t<Whole> at_or_setter_impl(Whole&& whole, Part&& part, Key&& key)
     return std::forward<Whole>(whole);
 }
 
-} // namespace detail
+// Provides the default value of an `at_or` lens of a given part type.
+// Returning a reference avoids copying it when viewing missing elements.
+struct default_constructed
+{
+    template <typename T>
+    const T& operator()(std::in_place_type_t<T>) const
+    {
+        static const T value{};
+        return value;
+    }
+};
 
-/*!
- * `Key -> Lens<{X}, X>`
- */
-template <typename Key>
-auto at_or(Key key)
+// The value is stored in the lens, which may be gone by the time the view is
+// used, so it is returned by value.
+template <typename Default>
+struct fallback_value
 {
-    return zug::comp([key](auto&& f) {
-        return [f = LAGER_FWD(f), &key](auto&& whole) {
-            using Part = std::decay_t<decltype(whole.at(key))>;
-            return f([&]() -> Part {
+    Default value;
+
+    template <typename T>
+    T operator()(std::in_place_type_t<T>) const
+    {
+        return T(value);
+    }
+};
+
+template <typename Fn>
+struct fallback_factory
+{
+    Fn fn;
+
+    template <typename T>
+    T operator()(std::in_place_type_t<T>) const
+    {
+        return fn();
+    }
+};
+
+// When the whole is an lvalue, and both the element and the default are
+// references, they are viewed without copying them.
+template <typename Key, typename Default>
+auto at_or_impl(Key key, Default def)
+{
+    return zug::comp([key, def = std::move(def)](auto&& f) {
+        return [f = LAGER_FWD(f), &key, &def](auto&& whole) {
+            using element_t = decltype(std::as_const(whole).at(key));
+            using Part      = std::decay_t<element_t>;
+            using default_t = decltype(def(std::in_place_type<Part>));
+            using view_t = std::conditional_t<
+                std::is_lvalue_reference_v<decltype(whole)> &&
+                    std::is_lvalue_reference_v<element_t> &&
+                    std::is_lvalue_reference_v<default_t>,
+                const Part&,
+                Part>;
+            return f([&]() -> view_t {
                 if (!detail::maybe_has_key(whole, key))
-                    return Part{};
-                LAGER_TRY { return LAGER_FWD(whole).at(key); }
-                LAGER_CATCH(std::out_of_range const&) { return Part{}; }
+                    return def(std::in_place_type<Part>);
+                LAGER_TRY { return std::as_const(whole).at(key); }
+                LAGER_CATCH(std::out_of_range const&)
+                {
+                    return def(std::in_place_type<Part>);
+                }
             }())([&](auto&& part) {
                 return detail::at_or_setter_impl(
                     LAGER_FWD(whole), LAGER_FWD(part), key);
@@ -80,26 +122,45 @@ auto at_or(Key key)
     });
 }
 
+} // namespace detail
+
+/*!
+ * `Key -> Lens<{X}, X>`
+ *
+ * Missing elements are viewed as a default constructed value, that is shared
+ * by all lenses with the same part type.  Viewing an lvalue returns a
+ * reference to the element or to that value, without copying them.
+ */
+template <typename Key>
+auto at_or(Key key)
+{
+    return detail::at_or_impl(std::move(key), detail::default_constructed{});
+}
+
 /*!
  * `Key, Default -> Lens<{X}, X>`
+ *
+ * Missing elements are viewed as a copy of `def`, that is stored in the lens.
  */
 template <typename Key, typename Default>
 auto at_or(Key key, Default&& def)
 {
-    return zug::comp([key, def = LAGER_FWD(def)](auto&& f) {
-        return [f = LAGER_FWD(f), &key, &def](auto&& whole) {
-            using Part = std::decay_t<decltype(whole.at(key))>;
-            return f([&]() -> Part {
-                if (!detail::maybe_has_key(whole, key))
-                    return def;
-                LAGER_TRY { return LAGER_FWD(whole).at(key); }
-                LAGER_CATCH(std::out_of_range const&) { return def; }
-            }())([&](auto&& part) {
-                return detail::at_or_setter_impl(
-                    LAGER_FWD(whole), LAGER_FWD(part), key);
-            });
-        };
-    });
+    return detail::at_or_impl(
+        std::move(key),
+        detail::fallback_value<std::decay_t<Default>>{LAGER_FWD(def)});
+}
+
+/*!
+ * `Key, (() -> X) -> Lens<{X}, X>`
+ *
+ * Missing elements are viewed as the result of calling `fn`, which is only
+ * called when the element is missing.
+ */
+template <typename Key, typename Fn>
+auto at_or_else(Key key, Fn&& fn)
+{
+    return detail::at_or_impl(
+        std::move(key), detail::fallback_factory<std::decay_t<Fn>>{LAGER_FWD(fn)});
 }
 
 } // namespace lenses
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <lager/lenses.hpp>
+#include <lager/lenses/at.hpp>
+#include <lager/util.hpp>
+
+#include <zug/compose.hpp>
+#include <zug/meta/detected.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lager {
+namespace lenses {
+namespace detail {
+
+template <typename T>
+using transient_t = decltype(std::declval<T>().transient());
+
+template <typename T>
+using mapped_type_t = typename T::mapped_type;
+
+// The elements of map-likes are their mapped values, and their positions are
+// their keys.  The positions of the elements of sequences are their indices.
+template <typename Whole>
+constexpr bool is_map_like = zug::meta::is_detected<mapped_type_t, Whole>::value;
+
+template <typename Whole, typename = void>
+struct element
+{
+    using type = typename Whole::value_type;
+};
+
+template <typename Whole>
+struct element<Whole, std::void_t<typename Whole::mapped_type>>
+{
+    using type = typename Whole::mapped_type;
+};
+
+template <typename Whole>
+using element_t = typename element<std::decay_t<Whole>>::type;
+
+template <typename Whole, typename = void>
+struct position
+{
+    using type = std::size_t;
+};
+
+template <typename Whole>
+struct position<Whole, std::void_t<typename Whole::mapped_type>>
+{
+    using type = typename Whole::key_type;
+};
+
+template <typename Whole>
+using position_t = typename position<std::decay_t<Whole>>::type;
+
+template <typename T>
+using transient_set_t =
+    decltype(std::declval<transient_t<const T&>&>().set(
+        std::declval<position_t<T>>(), std::declval<element_t<T>>()));
+
+template <typename T>
+using erase_value_t = decltype(std::declval<T&>().erase(
+    std::declval<const typename T::value_type&>()));
+
+template <typename T>
+using insert_value_t = decltype(std::declval<T&>().insert(
+    std::declval<typename T::value_type>()));
+
+// The elements of set-likes are their values, which can not be replaced in
+// place, so they are erased and the new values inserted instead.
+template <typename Whole>
+constexpr bool is_set_like =
+    !is_map_like<Whole> &&
+    zug::meta::is_detected<erase_value_t, Whole>::value &&
+    zug::meta::is_detected<insert_value_t, Whole>::value;
+
+// Calls `fn(position, element)` for every element of `whole`.
+template <typename Whole, typename Fn>
+void for_each_element(const Whole& whole, Fn&& fn)
+{
+    if constexpr (is_map_like<Whole>) {
+        for (const auto& kv : whole)
+            fn(kv.first, kv.second);
+    } else {
+        auto index = std::size_t{};
+        for (const auto& x : whole)
+            fn(index++, x);
+    }
+}
+
+// Erases the elements of the set-like `whole` chosen by `select` and then
+// inserts the result of calling `fn` on them, so that new values are not
+// erased when they are equal to some other chosen element.
+template <typename Whole, typename Select, typename Fn>
+std::decay_t<Whole>
+update_set_elements(Whole&& whole, const Select& select, Fn&& fn)
+{
+    using whole_t = std::decay_t<Whole>;
+    auto values   = std::vector<element_t<whole_t>>{};
+    if constexpr (zug::meta::is_detected<transient_t, const whole_t&>::value) {
+        auto t = whole.transient();
+        select(whole, [&](const auto&, const auto& x) {
+            values.push_back(fn(x));
+            t.erase(x);
+        });
+        for (auto& x : values)
+            t.insert(std::move(x));
+        return t.persistent();
+    } else {
+        auto r = whole_t{whole};
+        select(whole, [&](const auto&, const auto& x) {
+            values.push_back(fn(x));
+            r.erase(x);
+        });
+        for (auto& x : values)
+            r.insert(std::move(x));
+        return r;
+    }
+}
+
+// Replaces the elements of `whole` chosen by `select` with the result of
+// calling `fn` on them.  Immer containers are updated through a single
+// transient, or moving the intermediate results when they do not have one,
+// and other containers are copied once and modified in place.
+template <typename Whole, typename Select, typename Fn>
+std::decay_t<Whole> update_elements(Whole&& whole, const Select& select, Fn&& fn)
+{
+    using whole_t = std::decay_t<Whole>;
+    if constexpr (is_set_like<whole_t>) {
+        return update_set_elements(
+            std::forward<Whole>(whole), select, std::forward<Fn>(fn));
+    } else if constexpr (zug::meta::is_detected<transient_set_t,
+                                                whole_t>::value) {
+        auto t = whole.transient();
+        select(whole, [&](const auto& pos, const auto& x) { t.set(pos, fn(x)); });
+        return t.persistent();
+    } else if constexpr (zug::meta::is_detected<set_t,
+                                                whole_t,
+                                                position_t<whole_t>,
+                                                element_t<whole_t>>::value) {
+        auto r = whole_t{whole};
+        select(whole, [&](const auto& pos, const auto& x) {
+            r = std::move(r).set(pos, fn(x));
+        });
+        return r;
+    } else {
+        auto r = std::forward<Whole>(whole);
+        select(r, [&](const auto& pos, const auto& x) { r.at(pos) = fn(x); });
+        return r;
+    }
+}
+
+template <typename Select>
+constexpr auto make_traversal(Select select)
+{
+    return zug::comp([select](auto&& f) {
+        return [f = LAGER_FWD(f), &select](auto&& whole) {
+            using part_t    = element_t<decltype(whole)>;
+            using functor_t = std::decay_t<decltype(f(
+                std::declval<const part_t&>()))>;
+            if constexpr (::lager::detail::is_identity_functor<
+                              functor_t>::value) {
+                return ::lager::detail::make_identity_functor(
+                    update_elements(
+                        LAGER_FWD(whole), select, [&](const auto& x) {
+                            return part_t(f(x).value);
+                        }));
+            } else {
+                static_assert(
+                    ::lager::detail::is_const_functor<functor_t>::value,
+                    "traversals can only be used with view, set and over");
+                using view_t = std::decay_t<decltype(f(
+                    std::declval<const part_t&>()).value)>;
+                auto views = std::vector<view_t>{};
+                select(whole, [&](const auto&, const auto& x) {
+                    views.push_back(f(x).value);
+                });
+                return ::lager::detail::make_const_functor(std::move(views));
+            }
+        };
+    });
+}
+
+} // namespace detail
+
+//! @defgroup lenses
+//! @{
+
+/*!
+ * `Traversal<[X], X>`
+ *
+ * Focuses every element of a container, or every mapped value of a map.
+ * Like all traversals, it can only be used with `view()`, which returns a
+ * `std::vector` with the focused parts, `set()`, which sets all of them to
+ * the same value, and `over()`, which updates each of them.  Readers can be
+ * derived with them, but cursors can not.  The elements of sets are updated
+ * by erasing them and inserting the new values.
+ */
+ZUG_INLINE_CONSTEXPR auto each =
+    detail::make_traversal([](const auto& whole, auto&& fn) {
+        detail::for_each_element(whole, fn);
+    });
+
+/*!
+ * `(X -> bool) -> Traversal<[X], X>`
+ *
+ * Focuses the elements of a container, or mapped values of a map, that
+ * satisfy `pred`.
+ */
+template <typename Pred>
+auto filtered(Pred pred)
+{
+    return detail::make_traversal(
+        [pred = std::move(pred)](const auto& whole, auto&& fn) {
+            detail::for_each_element(
+                whole, [&](const auto& pos, const auto& x) {
+                    if (pred(x))
+                        fn(pos, x);
+                });
+        });
+}
+
+/*!
+ * `[Key] -> Traversal<{X}, X>`
+ *
+ * Focuses the elements of a container at the keys, or indices, in the
+ * collection `ks`.  The keys that are not in the container are skipped.
+ */
+template <typename Keys>
+auto keys(Keys ks)
+{
+    return detail::make_traversal(
+        [ks = std::move(ks)](const auto& whole, auto&& fn) {
+            for (const auto& k : ks)
+                if (detail::has_key(whole, k))
+                    fn(k, whole.at(k));
+        });
+}
+
+//! @}
+
+} // namespace lenses
+} // namespace lager
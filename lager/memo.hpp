@@ -0,0 +1,74 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/lru_cache.hpp>
+#include <lager/util.hpp>
+
+#include <zug/tuplify.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+namespace lager {
+
+namespace detail {
+
+constexpr std::size_t default_memo_capacity = 16;
+
+} // namespace detail
+
+//! @defgroup cursors
+//! @{
+
+/*!
+ * Returns a transducer like `zug::map(mapping)` that remembers the results of
+ * the last `capacity` distinct inputs, so `mapping` is not evaluated again
+ * when a node goes back to a value that it has recently seen, as it often
+ * happens with undo or when toggling filters.
+ *
+ * The inputs are copied into the cache and must be hashable with `std::hash`
+ * (which can be derived with `LAGER_DERIVE(HASH, ...)`) and equality
+ * comparable.  When the node has multiple parents, the key is the tuple of
+ * their values.  `mapping` must be a pure function.
+ *
+ * @note Each node derived with this transducer owns a separate cache.
+ */
+template <typename Mapping>
+auto map_memo(Mapping&& mapping,
+              std::size_t capacity = detail::default_memo_capacity)
+{
+    return [=](auto&& step) {
+        return [=, cache = std::shared_ptr<void>{}](auto&& s,
+                                                    auto&&... is) mutable {
+            using key_t   = std::decay_t<decltype(zug::tuplify(is...))>;
+            using value_t = std::decay_t<std::invoke_result_t<
+                std::decay_t<Mapping>&,
+                decltype(is)...>>;
+            using cache_t = detail::lru_cache<key_t, value_t>;
+            if (!cache)
+                cache = std::make_shared<cache_t>(capacity);
+            auto& c = *static_cast<cache_t*>(cache.get());
+            return step(LAGER_FWD(s),
+                        c.get(zug::tuplify(is...), [&] {
+                            return std::invoke(mapping, is...);
+                        }));
+        };
+    };
+}
+
+//! @}
+
+} // namespace lager
@@ -0,0 +1,61 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/access.hpp>
+#include <lager/detail/projection_nodes.hpp>
+#include <lager/reader.hpp>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace lager {
+
+//! @defgroup cursors
+//! @{
+
+/*!
+ * Returns a reader to the `member` of the value of `parent`, which can be any
+ * reader, cursor, state or store.  Unlike `parent[member]`, the resulting node
+ * does not store a copy of the member: it refers to the value that is already
+ * stored in the node of `parent`.  This saves memory and copies for long
+ * paths of member accesses into big models.
+ *
+ * The result is read-only, use `parent[member]` to get a cursor.
+ */
+template <typename Parent,
+          typename Member,
+          std::enable_if_t<std::is_member_object_pointer_v<Member>, int> = 0>
+auto project(const Parent& parent, Member member)
+{
+    auto node = detail::make_projection_reader_node(
+        detail::member_projection<Member>{member},
+        detail::access::node(parent));
+    return reader_base<typename decltype(node)::element_type>{std::move(node)};
+}
+
+/*!
+ * Returns a reader to the `Index`-th element of the tuple, pair or array in
+ * `parent`, without copying it.  @see `project(parent, member)`
+ */
+template <std::size_t Index, typename Parent>
+auto project(const Parent& parent)
+{
+    auto node = detail::make_projection_reader_node(
+        detail::element_projection<Index>{}, detail::access::node(parent));
+    return reader_base<typename decltype(node)::element_type>{std::move(node)};
+}
+
+//! @}
+
+} // namespace lager
@@ -26,6 +26,8 @@ class sensor_node_base : public root_node<T, reader_node>
 
 public:
     using base_t::base_t;
+
+    LAGER_DETAIL_NODE_KIND("sensor")
 };
 
 template <typename SensorFnT>
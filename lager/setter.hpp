@@ -14,6 +14,7 @@
 
 #include <lager/detail/access.hpp>
 #include <lager/detail/nodes.hpp>
+#include <lager/detail/write_batch.hpp>
 
 #include <lager/cursor.hpp>
 #include <lager/tags.hpp>
@@ -38,7 +39,11 @@ public:
         : base_t{p->current()}
         , parent_{std::move(p)}
         , setter_fn_{std::move(fn)}
-    {}
+    {
+        this->depth_ = parent_->depth() + 1;
+    }
+
+    LAGER_DETAIL_NODE_KIND("setter")
 
     void recompute() final
     {
@@ -52,6 +57,7 @@ public:
 
     void send_up(const value_type& value) override
     {
+        write_barrier(this->depth());
         setter_fn_(value);
         this->push_down(value);
         if constexpr (std::is_same_v<TagT, automatic_tag>) {
@@ -63,6 +69,7 @@ public:
 
     void send_up(value_type&& value) override
     {
+        write_barrier(this->depth());
         setter_fn_(value);
         this->push_down(std::move(value));
         if constexpr (std::is_same_v<TagT, automatic_tag>) {
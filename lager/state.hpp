@@ -16,6 +16,7 @@
 #include <lager/cursor.hpp>
 #include <lager/detail/access.hpp>
 #include <lager/detail/nodes.hpp>
+#include <lager/detail/write_batch.hpp>
 
 #include <lager/tags.hpp>
 #include <lager/util.hpp>
@@ -28,7 +29,10 @@ template <typename T>
 using state_base = root_node<T, cursor_node>;
 
 template <typename T, typename TagT = transactional_tag>
-class state_node : public state_base<T>
+class state_node
+    : public state_base<T>
+    , public batched_writer_node
+    , public std::enable_shared_from_this<state_node<T, TagT>>
 {
     using base_t = state_base<T>;
 
@@ -37,25 +41,54 @@ public:
 
     using base_t::base_t;
 
+    LAGER_DETAIL_NODE_KIND("state")
+
     virtual void recompute() final {}
 
     void send_up(const value_type& value) final
     {
+        write_barrier(0);
         this->push_down(value);
-        if constexpr (std::is_same_v<TagT, automatic_tag>) {
-            this->send_down();
-            this->notify();
-        }
+        propagate();
     }
 
     void send_up(value_type&& value) final
     {
+        write_barrier(0);
         this->push_down(std::move(value));
+        propagate();
+    }
+
+    void flush_up(const std::vector<batched_writer_node*>&) final
+    {
+        send_down_and_notify();
+    }
+
+    void discard_up() final
+    {
+        // The written values were not sent down yet.
+        this->push_down(this->last_);
+        this->needs_send_down_ = false;
+    }
+
+private:
+    void propagate()
+    {
         if constexpr (std::is_same_v<TagT, automatic_tag>) {
-            this->send_down();
-            this->notify();
+            // During a write batch, the children may have pending writes,
+            // which would be lost if they were recomputed now.
+            if (auto batch = write_batch_state::current())
+                batch->add(0, this->shared_from_this());
+            else
+                send_down_and_notify();
         }
     }
+
+    void send_down_and_notify()
+    {
+        this->send_down();
+        this->notify();
+    }
 };
 
 template <typename TagT = transactional_tag, typename T>
@@ -16,6 +16,7 @@
 #include <lager/deps.hpp>
 #include <lager/effect.hpp>
 #include <lager/state.hpp>
+#include <lager/tracing.hpp>
 #include <lager/util.hpp>
 
 #include <zug/compose.hpp>
@@ -40,6 +41,8 @@ struct store_node_base : public root_node<Model, reader_node>
     using base_t     = root_node<Model, reader_node>;
     using base_t::base_t;
 
+    LAGER_DETAIL_NODE_KIND("store")
+
     virtual void recompute() final {}
     virtual future dispatch(action_t action) = 0;
 };
@@ -133,6 +136,13 @@ private:
             Tags{}, boost::hana::type_c<transactional_tag>);
         static constexpr bool has_futures = boost::hana::contains(
             Tags{}, boost::hana::type_c<enable_futures_tag>);
+        static constexpr bool is_traced = boost::hana::contains(
+            Tags{}, boost::hana::type_c<tracing_tag>);
+
+        using trace_stamp_t = detail::trace_stamp<is_traced>;
+        using trace_scope_t = detail::trace_scope<is_traced>;
+
+        [[no_unique_address]] detail::trace_stamper<is_traced> trace_stamp_;
 
         store_node(model_t init_,
                    reducer_t reducer_,
@@ -156,7 +166,10 @@ private:
             }();
             loop.post([this,
                        p      = std::move(p),
-                       action = std::move(action)]() mutable {
+                       action = std::move(action),
+                       tr     = trace_stamp_()]() mutable {
+                trace_queued_(tr);
+                auto reducer_scope = trace_(trace_phase::reducer, tr);
                 base_t::push_down(invoke_reducer<deps_t>(
                     reducer,
                     base_t::current(),
@@ -164,29 +177,41 @@ private:
                     [&](auto&& effect) {
                         loop.post([this,
                                    p   = std::move(p),
-                                   eff = LAGER_FWD(effect)]() mutable {
+                                   eff = LAGER_FWD(effect),
+                                   tr]() mutable {
                             if constexpr (!is_transactional) {
-                                base_t::send_down();
-                                base_t::notify();
+                                send_down_and_notify_(tr);
                             }
                             auto& ctxMsvcWorkaround = ctx;
                             if constexpr (std::is_same_v<void,
                                     decltype(eff(ctxMsvcWorkaround))>) {
-                                eff(ctx);
+                                eval_effect_(eff, tr);
                                 if constexpr (has_futures)
                                     p();
                             } else {
-                                auto f = eff(ctx);
-                                if constexpr (has_futures)
+                                auto f = eval_effect_(eff, tr);
+                                if constexpr (has_futures && is_traced)
+                                    std::move(f).then(
+                                        [this,
+                                         p  = std::move(p),
+                                         tr = tr,
+                                         t0 = detail::trace_now()]() mutable {
+                                            tracer_().record(
+                                                {t0,
+                                                 detail::trace_now(),
+                                                 tr.action_id,
+                                                 trace_phase::effect_future});
+                                            p();
+                                        });
+                                else if constexpr (has_futures)
                                     std::move(f).then(std::move(p));
                             }
                         });
                     },
                     [&] {
                         if constexpr (!is_transactional) {
-                            loop.post([this, p = std::move(p)]() mutable {
-                                base_t::send_down();
-                                base_t::notify();
+                            loop.post([this, p = std::move(p), tr]() mutable {
+                                send_down_and_notify_(tr);
                                 if constexpr (has_futures)
                                     p();
                             });
@@ -196,6 +221,43 @@ private:
             });
             return std::move(f);
         }
+
+    private:
+        void send_down_and_notify_(const trace_stamp_t& tr)
+        {
+            {
+                auto scope = trace_(trace_phase::send_down, tr);
+                base_t::send_down();
+            }
+            auto scope = trace_(trace_phase::notify, tr);
+            base_t::notify();
+        }
+
+        template <typename Effect>
+        decltype(auto) eval_effect_(Effect& eff, const trace_stamp_t& tr)
+        {
+            auto scope = trace_(trace_phase::effect, tr);
+            return eff(ctx);
+        }
+
+        trace_sink& tracer_() const { return ctx.template get<tracing_tag>(); }
+
+        void trace_queued_(const trace_stamp_t& tr)
+        {
+            if constexpr (is_traced)
+                tracer_().record({tr.dispatched,
+                                  detail::trace_now(),
+                                  tr.action_id,
+                                  trace_phase::queue});
+        }
+
+        trace_scope_t trace_(trace_phase phase, const trace_stamp_t& tr)
+        {
+            if constexpr (is_traced)
+                return {&tracer_(), phase, tr};
+            else
+                return {nullptr, phase, tr};
+        }
     };
 
     template <typename ReducerFn,
@@ -0,0 +1,208 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/deps.hpp>
+#include <lager/util.hpp>
+
+#include <boost/hana/set.hpp>
+#include <boost/hana/union.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace lager {
+
+//! @defgroup tracing
+//! @{
+
+/*!
+ * Tag that marks stores that trace the processing of their actions.
+ */
+struct tracing_tag
+{};
+
+/*!
+ * The phases in which the processing of an action is split when tracing.
+ */
+enum class trace_phase : std::uint8_t
+{
+    //! From `dispatch()` until the event loop starts processing the action.
+    queue,
+    //! Evaluation of the reducer.
+    reducer,
+    //! Propagation of the new model through the node graph.
+    send_down,
+    //! Notification of the watchers.
+    notify,
+    //! Synchronous evaluation of the effect.
+    effect,
+    //! From the evaluation of the effect until the future it returned
+    //! completes.  Only traced on stores with futures enabled.
+    effect_future,
+};
+
+inline const char* to_string(trace_phase phase)
+{
+    switch (phase) {
+    case trace_phase::queue:
+        return "queue";
+    case trace_phase::reducer:
+        return "reducer";
+    case trace_phase::send_down:
+        return "send_down";
+    case trace_phase::notify:
+        return "notify";
+    case trace_phase::effect:
+        return "effect";
+    case trace_phase::effect_future:
+        return "effect_future";
+    }
+    return "unknown";
+}
+
+/*!
+ * A traced phase of the processing of an action.  Times are in nanoseconds of
+ * the `std::chrono::steady_clock`.
+ */
+struct trace_event
+{
+    std::int64_t begin;
+    std::int64_t end;
+    std::uint64_t action_id;
+    trace_phase phase;
+};
+
+/*!
+ * Interface for receiving the events of a traced store.  Events are recorded
+ * from the thread of the event loop of the store.
+ */
+struct trace_sink
+{
+    virtual ~trace_sink()                   = default;
+    virtual void record(const trace_event&) = 0;
+};
+
+namespace detail {
+
+inline std::int64_t trace_now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/*!
+ * Per action tracing information that travels with the closures posted by the
+ * store.  It is empty when tracing is disabled.
+ */
+template <bool Enabled>
+struct trace_stamp
+{};
+
+template <>
+struct trace_stamp<true>
+{
+    std::uint64_t action_id;
+    std::int64_t dispatched;
+};
+
+/*!
+ * Produces the stamps for newly dispatched actions.
+ */
+template <bool Enabled>
+struct trace_stamper
+{
+    trace_stamp<false> operator()() { return {}; }
+};
+
+template <>
+struct trace_stamper<true>
+{
+    std::atomic<std::uint64_t> next_id{};
+
+    trace_stamp<true> operator()() { return {next_id++, trace_now()}; }
+};
+
+/*!
+ * Records the phase in which it is alive, when tracing is enabled.
+ */
+template <bool Enabled>
+struct trace_scope
+{
+    trace_scope(trace_sink*, trace_phase, const trace_stamp<Enabled>&) {}
+};
+
+template <>
+struct trace_scope<true>
+{
+    trace_sink* sink;
+    trace_phase phase;
+    std::uint64_t action_id;
+    std::int64_t begin = trace_now();
+
+    trace_scope(trace_sink* s, trace_phase p, const trace_stamp<true>& stamp)
+        : sink{s}
+        , phase{p}
+        , action_id{stamp.action_id}
+    {}
+
+    trace_scope(const trace_scope&) = delete;
+    trace_scope& operator=(const trace_scope&) = delete;
+
+    ~trace_scope() { sink->record({begin, trace_now(), action_id, phase}); }
+};
+
+} // namespace detail
+
+/*!
+ * Store enhancer that traces how the actions are processed: how long they wait
+ * in the event loop, and the time spent in the reducer, propagating and
+ * notifying changes and evaluating effects.  The events are sent to `sink`,
+ * which must outlive the store.
+ *
+ * When this enhancer is not used, the tracing code is compiled out of the
+ * store.
+ *
+ * @see `lager/extra/chrome_trace.hpp` for sinks that produce files that can be
+ *      loaded in trace viewers.
+ */
+inline auto with_tracing(trace_sink& sink)
+{
+    return [&sink](auto next) {
+        return [&sink, next](auto action,
+                             auto&& model,
+                             auto&& reducer,
+                             auto&& loop,
+                             auto&& deps,
+                             auto&& tags) {
+            using sink_dep_t  = dep::key<tracing_tag, trace_sink&>;
+            auto sink_deps    = lager::deps<sink_dep_t>::with(std::ref(sink));
+            return next(action,
+                        LAGER_FWD(model),
+                        LAGER_FWD(reducer),
+                        LAGER_FWD(loop),
+                        LAGER_FWD(deps).merge(std::move(sink_deps)),
+                        boost::hana::union_(
+                            LAGER_FWD(tags),
+                            boost::hana::make_set(
+                                boost::hana::type_c<tracing_tag>)));
+        };
+    };
+}
+
+//! @} group: tracing
+
+} // namespace lager
@@ -16,6 +16,7 @@
 #include <lager/detail/merge_nodes.hpp>
 #include <lager/detail/xform_nodes.hpp>
 
+#include <lager/memo.hpp>
 #include <lager/tags.hpp>
 
 #include <zug/transducer/filter.hpp>
@@ -98,6 +99,22 @@ struct xform_mixin
         return static_cast<Deriv&&>(std::move(*this))
             .xform(zug::filter(std::forward<Args>(args))...);
     }
+
+    //! @see `lager::map_memo`
+    template <typename Mapping>
+    auto map_memo(Mapping&& mapping,
+                  std::size_t capacity = detail::default_memo_capacity) const&
+    {
+        return static_cast<const Deriv&>(*this).xform(
+            lager::map_memo(std::forward<Mapping>(mapping), capacity));
+    }
+    template <typename Mapping>
+    auto map_memo(Mapping&& mapping,
+                  std::size_t capacity = detail::default_memo_capacity) &&
+    {
+        return static_cast<Deriv&&>(std::move(*this))
+            .xform(lager::map_memo(std::forward<Mapping>(mapping), capacity));
+    }
 };
 
 //! @}
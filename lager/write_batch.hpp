@@ -0,0 +1,81 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/write_batch.hpp>
+
+#include <exception>
+
+namespace lager {
+
+//! @defgroup cursors
+//! @{
+
+/*!
+ * Batches the writes to cursors in the current thread for as long as it is
+ * alive.  Normally, every `set()` or `update()` of a cursor derived with
+ * lenses rebuilds the values of all its ancestors up to the root.  While a
+ * batch is open, the written values are instead kept in the cursor nodes, and
+ * they are sent up when the batch is flushed, deepest nodes first, so every
+ * ancestor is rebuilt only once with all the writes to its descendants.
+ * Sibling cursors, derived from the same node, are sent up together, so
+ * their writes are applied to a single copy of the value of their parent.
+ *
+ * The batch is flushed when calling `flush()`, when committing with
+ * `lager::commit()` and when it is destroyed.  Batches can be nested, in which
+ * case the writes are flushed when the outermost one is destroyed.  The
+ * writes are observably applied in the same order as without a batch.
+ *
+ * @note When the batch is destroyed because of an exception, the pending
+ *       writes are discarded, and the cursors that held them are
+ *       recomputed from their parents.
+ */
+class write_batch
+{
+    detail::write_batch_state state_;
+    bool owner_     = false;
+    int exceptions_ = std::uncaught_exceptions();
+
+public:
+    write_batch()
+    {
+        auto& current = detail::write_batch_state::current();
+        if (!current) {
+            current = &state_;
+            owner_  = true;
+        }
+    }
+
+    write_batch(const write_batch&) = delete;
+    write_batch& operator=(const write_batch&) = delete;
+
+    ~write_batch()
+    {
+        if (owner_) {
+            if (std::uncaught_exceptions() > exceptions_)
+                state_.discard();
+            else
+                state_.flush();
+            detail::write_batch_state::current() = nullptr;
+        }
+    }
+
+    /*!
+     * Sends up all the pending writes.
+     */
+    void flush() { detail::write_batch_state::current()->flush(); }
+};
+
+//! @}
+
+} // namespace lager
@@ -0,0 +1,61 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include "cerealize.hpp"
+
+#include <lager/extra/cereal/immer_map.hpp>
+
+#include <cereal/types/string.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+namespace {
+
+struct entry_t
+{
+    size_t id;
+    std::string value;
+
+    bool operator==(const entry_t& other) const
+    {
+        return id == other.id && value == other.value;
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar)
+    {
+        ar(CEREAL_NVP(id), CEREAL_NVP(value));
+    }
+};
+
+} // namespace
+
+TEST_CASE("basic")
+{
+    auto x = immer::map<std::string, size_t>{}.set("a", 1).set("b", 2);
+    for (auto i = size_t{}; i < 100; ++i)
+        x = std::move(x).set(std::to_string(i), i);
+    auto y = cerealize(x);
+    CHECK(x == y);
+}
+
+TEST_CASE("auto id")
+{
+    auto x = immer::map<size_t, entry_t>{}
+                 .set(1, {1, "foo"})
+                 .set(3, {3, "bar"})
+                 .set(42, {42, "baz"});
+    auto y = cerealize(x);
+    CHECK(x == y);
+}
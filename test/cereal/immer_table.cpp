@@ -14,8 +14,14 @@
 
 #include <lager/extra/cereal/immer_table.hpp>
 
+#include <cereal/types/vector.hpp>
+
 #include <catch2/catch.hpp>
 
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
 struct entry_t
 {
     size_t id;
@@ -42,3 +48,27 @@ TEST_CASE("basic")
     auto y = cerealize(x);
     CHECK(x == y);
 }
+
+TEST_CASE("many entries")
+{
+    auto x = immer::table<entry_t>{};
+    for (auto i = size_t{}; i < 1000; ++i)
+        x = std::move(x).insert({i * 7, i});
+    auto y = cerealize(x);
+    CHECK(x == y);
+    CHECK(y.size() == 1000);
+    CHECK(y[7 * 42].value == 42);
+}
+
+TEST_CASE("duplicate ids")
+{
+    auto os = std::ostringstream{};
+    {
+        auto ar = cereal::JSONOutputArchive{os};
+        ar(std::vector<entry_t>{{1, 2}, {1, 3}});
+    }
+    auto is = std::istringstream{os.str()};
+    auto ar = cereal::JSONInputArchive{is};
+    auto x  = immer::table<entry_t>{};
+    CHECK_THROWS_AS(ar(x), std::runtime_error);
+}
@@ -0,0 +1,107 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <lager/extra/cereal/immer_box.hpp>
+#include <lager/extra/cereal/immer_flex_vector.hpp>
+#include <lager/extra/cereal/immer_map.hpp>
+#include <lager/extra/cereal/immer_vector.hpp>
+#include <lager/extra/cereal/sharing.hpp>
+
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename T>
+std::string save_binary(const T& x)
+{
+    auto os = std::ostringstream{};
+    {
+        auto ar = cereal::BinaryOutputArchive{os};
+        ar(x);
+    }
+    return os.str();
+}
+
+template <typename T>
+std::string save_shared(const T& x)
+{
+    auto os = std::ostringstream{};
+    {
+        auto ar = lager::shared_binary_output_archive{os};
+        ar(x);
+    }
+    return os.str();
+}
+
+template <typename T>
+T load_shared(const std::string& data)
+{
+    auto is = std::istringstream{data};
+    auto ar = lager::shared_binary_input_archive{is};
+    auto x  = T{};
+    ar(x);
+    return x;
+}
+
+} // namespace
+
+static_assert(lager::detail::preserves_sharing<
+              lager::shared_binary_output_archive>);
+static_assert(lager::detail::preserves_sharing<
+              lager::shared_binary_input_archive>);
+static_assert(!lager::detail::preserves_sharing<cereal::BinaryOutputArchive>);
+static_assert(!lager::detail::preserves_sharing<cereal::BinaryInputArchive>);
+
+TEST_CASE("sharing, boxes are saved once")
+{
+    using history_t = std::vector<immer::box<std::string>>;
+
+    auto big     = immer::box<std::string>{std::string(1000, 'x')};
+    auto history = history_t{big, big, big, immer::box<std::string>{"foo"}};
+
+    auto data = save_shared(history);
+    CHECK(data.size() < save_binary(history).size() / 2);
+
+    auto loaded = load_shared<history_t>(data);
+    CHECK(loaded == history);
+    CHECK(&loaded[0].get() == &loaded[1].get());
+    CHECK(&loaded[0].get() == &loaded[2].get());
+    CHECK(&loaded[0].get() != &loaded[3].get());
+}
+
+TEST_CASE("sharing, containers are saved once")
+{
+    using model_t   = immer::flex_vector<int>;
+    using history_t = std::vector<immer::map<int, model_t>>;
+
+    auto items = model_t{};
+    for (auto i = 0; i < 1000; ++i)
+        items = std::move(items).push_back(i);
+    auto v1      = immer::map<int, model_t>{}.set(1, items);
+    auto v2      = v1.set(2, model_t{1, 2, 3});
+    auto history = history_t{v1, v2, v2.set(2, model_t{})};
+
+    auto data = save_shared(history);
+    CHECK(data.size() < save_binary(history).size() / 2);
+
+    auto loaded = load_shared<history_t>(data);
+    CHECK(loaded == history);
+    CHECK(loaded[0][1].impl().root == loaded[1][1].impl().root);
+    CHECK(loaded[1][1].impl().root == loaded[2][1].impl().root);
+}
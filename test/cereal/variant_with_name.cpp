@@ -14,9 +14,25 @@
 #include <catch2/catch.hpp>
 #include <lager/extra/cereal/variant_with_name.hpp>
 
+#include <cereal/types/string.hpp>
+
+#include <string>
+
 TEST_CASE("basic")
 {
     auto x = std::variant<int, std::monostate, float>{std::monostate{}};
     auto y = cerealize(x);
     CHECK(x == y);
 }
+
+TEST_CASE("every alternative")
+{
+    using variant_t = std::variant<int, std::string, float, std::monostate>;
+    for (auto x : {variant_t{42},
+                   variant_t{std::string{"foo"}},
+                   variant_t{1.5f},
+                   variant_t{std::monostate{}}}) {
+        auto y = cerealize(x);
+        CHECK(x == y);
+    }
+}
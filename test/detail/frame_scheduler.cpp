@@ -0,0 +1,126 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+
+#include <catch2/catch.hpp>
+
+#include <lager/detail/frame_scheduler.hpp>
+
+#include <chrono>
+
+using namespace lager::detail;
+
+namespace {
+
+struct fake_clock
+{
+    using duration   = std::chrono::microseconds;
+    using rep        = duration::rep;
+    using period     = duration::period;
+    using time_point = std::chrono::time_point<fake_clock>;
+
+    static constexpr bool is_steady = true;
+
+    static time_point current;
+
+    static time_point now() { return current; }
+    static void advance(float ms)
+    {
+        current += duration{static_cast<rep>(ms * 1000)};
+    }
+};
+
+fake_clock::time_point fake_clock::current = {};
+
+} // namespace
+
+TEST_CASE("frame scheduler, posts get what is left of the budget")
+{
+    auto s = frame_scheduler<fake_clock>{};
+    s.start(16);
+    CHECK(s.budget() == 8);
+
+    auto left = -1.f;
+    s.begin_frame();
+    fake_clock::advance(3);
+    s.run_posts([&](float budget) {
+        left = budget;
+        return false;
+    });
+    CHECK(left == Approx(5));
+
+    s.begin_frame();
+    fake_clock::advance(10);
+    s.run_posts([&](float budget) {
+        left = budget;
+        return true;
+    });
+    CHECK(left == 0);
+    s.end_frame();
+    CHECK(s.stats().deferred_frames == 1);
+
+    s.set_budget(12);
+    s.begin_frame();
+    s.run_posts([&](float budget) {
+        left = budget;
+        return false;
+    });
+    CHECK(left == 12);
+}
+
+TEST_CASE("frame scheduler, measures the whole frame")
+{
+    auto s = frame_scheduler<fake_clock>{};
+    s.start(16);
+    for (auto i = 0; i < 4; ++i) {
+        s.begin_frame();
+        fake_clock::advance(2);
+        s.run_posts([](float) {
+            fake_clock::advance(4);
+            return false;
+        });
+        // the tick function, rendering
+        fake_clock::advance(i < 3 ? 6 : 20);
+        s.end_frame();
+    }
+    auto stats = s.stats();
+    CHECK(stats.frames == 4);
+    CHECK(stats.dropped_frames == 1);
+    CHECK(stats.deferred_frames == 0);
+    CHECK(stats.frame_p50 == Approx(12));
+    CHECK(stats.frame_max == Approx(26));
+    CHECK(stats.posts_p50 == Approx(4));
+}
+
+TEST_CASE("frame scheduler, does not count waiting for the next frame")
+{
+    auto s = frame_scheduler<fake_clock>{};
+    s.start(16);
+    for (auto i = 0; i < 4; ++i) {
+        s.begin_frame();
+        fake_clock::advance(2);
+        // waiting for the deadline, oversleeping a bit
+        auto dt = s.idle([] {
+            fake_clock::advance(15);
+            return 16.f;
+        });
+        CHECK(dt == 16);
+        // the tick function, rendering
+        fake_clock::advance(4);
+        s.end_frame();
+    }
+    auto stats = s.stats();
+    CHECK(stats.frames == 4);
+    CHECK(stats.dropped_frames == 0);
+    CHECK(stats.frame_p50 == Approx(6));
+    CHECK(stats.frame_max == Approx(6));
+}
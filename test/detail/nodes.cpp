@@ -280,3 +280,63 @@ TEST_CASE("node, one node two parents")
     CHECK(71 == z->last());
     CHECK(3 == s.count());
 }
+
+TEST_CASE("node, merge copies only changed parents")
+{
+    auto x = make_state_node(1);
+    auto y = make_state_node(std::array<int, 3>{1, 2, 3});
+    auto z = make_merge_reader_node(std::make_tuple(x, y));
+    auto s = testing::spy();
+    auto c = z->observers().connect(s);
+    CHECK(std::make_tuple(1, std::array<int, 3>{1, 2, 3}) == z->last());
+
+    auto version = z->version();
+    x->push_down(2);
+    x->send_down();
+    x->notify();
+    CHECK(std::make_tuple(2, std::array<int, 3>{1, 2, 3}) == z->last());
+    CHECK(1 == s.count());
+    CHECK(version != z->version());
+
+    version = z->version();
+    y->push_down(std::array<int, 3>{1, 2, 3});
+    y->send_down();
+    y->notify();
+    CHECK(1 == s.count());
+    CHECK(version == z->version());
+
+    // the version of the parent changes, but not its value
+    x->push_down(3);
+    x->push_down(2);
+    x->send_down();
+    x->notify();
+    CHECK(1 == s.count());
+    CHECK(version == z->version());
+}
+
+TEST_CASE("node, refresh skips ancestors that are up to date")
+{
+    auto count = 0;
+    auto inc   = map([&](int x) {
+        ++count;
+        return x + 1;
+    });
+    auto x     = make_state_node(0);
+    auto y     = make_xform_reader_node(inc, std::make_tuple(x));
+    auto z     = make_xform_reader_node(inc, std::make_tuple(y));
+    CHECK(2 == count);
+
+    z->refresh();
+    z->refresh();
+    CHECK(2 == count);
+
+    x->push_down(5);
+    z->refresh();
+    CHECK(7 == z->current());
+    CHECK(4 == count);
+
+    x->send_down();
+    z->refresh();
+    CHECK(7 == z->last());
+    CHECK(4 == count);
+}
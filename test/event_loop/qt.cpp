@@ -18,6 +18,7 @@
 #include <lager/store.hpp>
 
 #include <thread>
+#include <vector>
 
 namespace {
 
@@ -118,3 +119,69 @@ TEST_CASE("manualy defined thread pool")
         loop::model{}, lager::with_qt_event_loop{app, thread_pool});
     run_test(store, store);
 }
+
+TEST_CASE("posts are coalesced")
+{
+    int argc = 0;
+    QCoreApplication app{argc, nullptr};
+    auto loop   = lager::with_qt_event_loop{app};
+    auto called = std::vector<int>{};
+
+    loop.post([&] { called.push_back(1); });
+    loop.post([&] { called.push_back(2); });
+    loop.post([&] { called.push_back(3); });
+    CHECK(called.empty());
+
+    QCoreApplication::sendPostedEvents(&app, QEvent::MetaCall);
+    CHECK(called == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("pause and resume")
+{
+    int argc = 0;
+    QCoreApplication app{argc, nullptr};
+    auto loop   = lager::with_qt_event_loop{app};
+    auto called = 0;
+
+    loop.pause();
+    loop.post([&] { ++called; });
+    QCoreApplication::processEvents();
+    CHECK(called == 0);
+
+    loop.resume();
+    QCoreApplication::processEvents();
+    CHECK(called == 1);
+}
+
+TEST_CASE("copies share the queue and can be assigned")
+{
+    int argc = 0;
+    QCoreApplication app{argc, nullptr};
+    auto called = 0;
+    auto loop   = lager::with_qt_event_loop{app};
+    {
+        auto copy = loop;
+        copy.post([&] { ++called; });
+    }
+    QCoreApplication::sendPostedEvents(&app, QEvent::MetaCall);
+    CHECK(called == 1);
+
+    auto other = lager::with_qt_event_loop{app};
+    other      = loop;
+    other.post([&] { ++called; });
+    QCoreApplication::sendPostedEvents(&app, QEvent::MetaCall);
+    CHECK(called == 2);
+
+    // discarding the closures of a queue does not affect the other queues on
+    // the same object
+    auto pending = lager::with_qt_event_loop{app};
+    auto dropped = lager::with_qt_event_loop{app};
+    pending.post([&] { ++called; });
+    dropped.post([&] { called += 100; });
+    dropped = pending;
+    QCoreApplication::sendPostedEvents(&app, QEvent::MetaCall);
+    CHECK(called == 3);
+    pending.post([&] { ++called; });
+    QCoreApplication::sendPostedEvents(&app, QEvent::MetaCall);
+    CHECK(called == 4);
+}
@@ -53,3 +53,37 @@ TEST_CASE("to_enum")
     CHECK(lager::to_enum<ns::kinds>("good") == ns::kinds::good);
     CHECK(lager::to_enum<ns::kinds>("bad") == ns::kinds::bad);
 }
+
+namespace ns {
+enum class sparse : unsigned char
+{
+    a    = 2,
+    b    = 200,
+    c    = 7,
+    d    = 7,
+    zeta = 0,
+};
+} // namespace ns
+
+LAGER_ENUM(ns, sparse, a, b, c, d, zeta);
+
+TEST_CASE("sparse values")
+{
+    CHECK(lager::to_string(ns::sparse::a) == std::string{"a"});
+    CHECK(lager::to_string(ns::sparse::b) == std::string{"b"});
+    CHECK(lager::to_string(ns::sparse::c) == std::string{"c"});
+    CHECK(lager::to_string(ns::sparse::d) == std::string{"c"});
+    CHECK(lager::to_string(ns::sparse::zeta) == std::string{"zeta"});
+    CHECK(lager::to_enum<ns::sparse>("d") == ns::sparse::c);
+    CHECK(lager::to_enum<ns::sparse>("zeta") == ns::sparse::zeta);
+}
+
+TEST_CASE("unknown values")
+{
+    CHECK_THROWS_AS(lager::to_string(static_cast<ns::kinds>(2)),
+                    std::runtime_error);
+    CHECK_THROWS_AS(lager::to_string(static_cast<ns::sparse>(3)),
+                    std::runtime_error);
+    CHECK_THROWS_AS(lager::to_enum<ns::kinds>("ugly"), std::runtime_error);
+    CHECK_THROWS_AS(lager::to_enum<ns::kinds>(""), std::runtime_error);
+}
@@ -0,0 +1,297 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+
+#include <catch2/catch.hpp>
+
+#include <lager/extra/incremental_snapshot.hpp>
+#include <lager/extra/struct.hpp>
+
+#include <immer/flex_vector.hpp>
+#include <immer/map.hpp>
+#include <immer/set.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ns {
+
+struct item
+{
+    std::string text;
+    bool done;
+};
+
+struct doc
+{
+    std::vector<item> items;
+    std::map<std::string, int> counts;
+    std::optional<item> selected;
+    std::string title;
+};
+
+struct sample
+{
+    static inline auto comparisons = 0;
+
+    int value;
+
+    bool operator==(const sample& other) const
+    {
+        ++comparisons;
+        return value == other.value;
+    }
+};
+
+struct archive
+{
+    immer::flex_vector<sample> samples;
+    immer::map<int, int> counts;
+    immer::set<int> tags;
+};
+
+} // namespace ns
+
+LAGER_STRUCT(ns, item, text, done);
+LAGER_STRUCT(ns, doc, items, counts, selected, title);
+LAGER_STRUCT(ns, archive, samples, counts, tags);
+
+namespace {
+
+const auto fname = std::string{"lager-test-incremental-snapshot.bin"};
+
+std::size_t file_size(const std::string& name)
+{
+    auto is = std::ifstream{name, std::ios::binary | std::ios::ate};
+    return is ? static_cast<std::size_t>(is.tellg()) : 0;
+}
+
+struct cleanup
+{
+    ~cleanup()
+    {
+        std::remove(fname.c_str());
+        std::remove((fname + ".delta").c_str());
+    }
+};
+
+ns::doc make_doc()
+{
+    auto x = ns::doc{};
+    for (auto i = 0; i < 100; ++i) {
+        x.items.push_back({"item " + std::to_string(i), false});
+        x.counts["key " + std::to_string(i)] = i;
+    }
+    x.selected = x.items[0];
+    return x;
+}
+
+} // namespace
+
+TEST_CASE("incremental snapshot, writes only changes")
+{
+    auto guard = cleanup{};
+    auto x     = make_doc();
+    auto s     = lager::incremental_snapshot<ns::doc>{fname};
+    s.save(x);
+    auto base = file_size(fname);
+    CHECK(s.deltas() == 0);
+
+    s.save(x);
+    CHECK(s.deltas() == 0);
+    CHECK(file_size(fname + ".delta") == 0);
+
+    x.items[42].done = true;
+    x.counts.erase("key 1");
+    x.counts["key 2"] = 42;
+    x.counts["new"]   = 5;
+    x.selected->text  = "selected";
+    s.save(x);
+    CHECK(s.deltas() == 1);
+    CHECK(file_size(fname) == base);
+    CHECK(file_size(fname + ".delta") < base / 4);
+
+    x.items.push_back({"last", true});
+    x.selected.reset();
+    x.title = "title";
+    s.save(x);
+    CHECK(s.deltas() == 2);
+
+    auto y = lager::incremental_snapshot<ns::doc>{fname}.load();
+    CHECK(x == y);
+}
+
+TEST_CASE("incremental snapshot, skips what immer containers share")
+{
+    auto guard = cleanup{};
+    auto x     = ns::archive{};
+    for (auto i = 0; i < 10000; ++i) {
+        x.samples = std::move(x.samples).push_back({i});
+        x.counts  = std::move(x.counts).set(i, i);
+        x.tags    = std::move(x.tags).insert(i);
+    }
+    auto s = lager::incremental_snapshot<ns::archive>{fname};
+    s.save(x);
+
+    auto y    = x;
+    y.samples = std::move(y.samples).set(5000, {-1});
+    y.counts  = std::move(y.counts).set(42, -1).erase(43).set(-1, 1);
+    y.tags    = std::move(y.tags).erase(7).insert(-7);
+    ns::sample::comparisons = 0;
+    s.save(y);
+    CHECK(ns::sample::comparisons < 1000);
+    CHECK(s.deltas() == 1);
+    CHECK(file_size(fname + ".delta") < 500);
+    CHECK(lager::incremental_snapshot<ns::archive>{fname}.load() == y);
+}
+
+TEST_CASE("incremental snapshot, compacts the changes")
+{
+    auto guard = cleanup{};
+    auto x     = make_doc();
+    auto s     = lager::incremental_snapshot<ns::doc>{fname, 0, 2};
+    s.save(x);
+    for (auto i = 0; i < 2; ++i) {
+        x.items[i].done = true;
+        s.save(x);
+    }
+    CHECK(s.deltas() == 2);
+    x.title = "compacted";
+    s.save(x);
+    CHECK(s.deltas() == 0);
+    CHECK(file_size(fname + ".delta") == 0);
+    CHECK(lager::incremental_snapshot<ns::doc>{fname}.load() == x);
+}
+
+TEST_CASE("incremental snapshot, continues after loading")
+{
+    auto guard = cleanup{};
+    auto x     = make_doc();
+    lager::incremental_snapshot<ns::doc>{fname}.save(x);
+
+    auto s = lager::incremental_snapshot<ns::doc>{fname};
+    auto y = s.load();
+    CHECK(x == y);
+    y.title = "loaded";
+    s.save(y);
+    CHECK(s.deltas() == 1);
+    CHECK(lager::incremental_snapshot<ns::doc>{fname}.load() == y);
+}
+
+TEST_CASE("incremental snapshot, discards an interrupted save")
+{
+    auto guard = cleanup{};
+    auto x     = make_doc();
+    auto s     = lager::incremental_snapshot<ns::doc>{fname};
+    s.save(x);
+    auto y  = x;
+    y.title = "saved";
+    s.save(y);
+    {
+        auto os = std::ofstream{fname + ".delta",
+                                std::ios::binary | std::ios::app};
+        os << "garbage";
+    }
+    CHECK(lager::incremental_snapshot<ns::doc>{fname}.load() == y);
+}
+
+TEST_CASE("incremental snapshot, saves after an interrupted save")
+{
+    auto guard = cleanup{};
+    auto x     = make_doc();
+    auto s     = lager::incremental_snapshot<ns::doc>{fname};
+    s.save(x);
+    x.title = "saved";
+    s.save(x);
+    {
+        auto os = std::ofstream{fname + ".delta",
+                                std::ios::binary | std::ios::app};
+        os << "garbage";
+    }
+
+    auto s2 = lager::incremental_snapshot<ns::doc>{fname};
+    auto y  = s2.load();
+    CHECK(x == y);
+    y.items[1].done = true;
+    s2.save(y);
+    CHECK(s2.deltas() == 2);
+    CHECK(lager::incremental_snapshot<ns::doc>{fname}.load() == y);
+}
+
+TEST_CASE("incremental snapshot, discards an invalid last delta")
+{
+    auto guard = cleanup{};
+    auto x     = make_doc();
+    auto s     = lager::incremental_snapshot<ns::doc>{fname};
+    s.save(x);
+    auto y  = x;
+    y.title = "saved";
+    s.save(y);
+    {
+        // a tail of zeroes, as left by a crash before the data is written
+        auto size  = std::uint64_t{64};
+        auto zeros = std::string(size, '\0');
+        auto os    = std::ofstream{fname + ".delta",
+                                std::ios::binary | std::ios::app};
+        os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        os << zeros;
+    }
+
+    auto s2 = lager::incremental_snapshot<ns::doc>{fname};
+    CHECK(s2.load() == y);
+    CHECK(s2.deltas() == 1);
+    y.items[1].done = true;
+    s2.save(y);
+    CHECK(lager::incremental_snapshot<ns::doc>{fname}.load() == y);
+}
+
+TEST_CASE("incremental snapshot, skips the deltas of an older snapshot")
+{
+    auto guard = cleanup{};
+    auto x     = make_doc();
+    auto s     = lager::incremental_snapshot<ns::doc>{fname};
+    s.save(x);
+    auto y  = x;
+    y.title = "changed";
+    s.save(y);
+    auto log = std::string{};
+    {
+        auto is = std::ifstream{fname + ".delta", std::ios::binary};
+        log.assign(std::istreambuf_iterator<char>{is},
+                   std::istreambuf_iterator<char>{});
+    }
+
+    // compacting the same contents again, interrupted before the log of the
+    // previous snapshot is removed
+    s.compact(x);
+    {
+        auto os = std::ofstream{fname + ".delta", std::ios::binary};
+        os << log;
+    }
+    CHECK(lager::incremental_snapshot<ns::doc>{fname}.load() == x);
+}
+
+TEST_CASE("incremental snapshot, invalid files")
+{
+    auto guard = cleanup{};
+    CHECK_THROWS_AS((lager::incremental_snapshot<ns::doc>{fname}.load()),
+                    lager::snapshot_error);
+    lager::incremental_snapshot<ns::doc>{fname, 1}.save(make_doc());
+    CHECK_THROWS_AS((lager::incremental_snapshot<ns::doc>{fname, 2}.load()),
+                    lager::snapshot_error);
+}
@@ -0,0 +1,110 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch2/catch.hpp>
+
+#include <lager/extra/path_lens.hpp>
+#include <lager/extra/struct.hpp>
+
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace ns {
+
+struct todo
+{
+    bool done;
+    std::string text;
+};
+
+struct note
+{
+    int priority;
+};
+
+struct model
+{
+    std::vector<todo> todos;
+    std::map<std::string, int> tags;
+    std::optional<todo> current;
+    std::variant<todo, note> item;
+};
+
+} // namespace ns
+
+LAGER_STRUCT(ns, todo, done, text);
+LAGER_STRUCT(ns, note, priority);
+LAGER_STRUCT(ns, model, todos, tags, current, item);
+
+using namespace lager;
+using namespace ns;
+
+TEST_CASE("path lens, members and containers")
+{
+    auto m = model{{{false, "foo"}, {true, "bar"}}, {{"work", 1}}, {}, note{5}};
+
+    auto text = path_lens<model, std::string>("todos/1/text");
+    CHECK(view(text, m) == "bar");
+    CHECK(view(text, set(text, m, std::string{"baz"})) == "baz");
+    CHECK(view(path_lens<model, std::string>("todos/2/text"), m) ==
+          std::nullopt);
+    CHECK(view(path_lens<model, int>("tags/work"), m) == 1);
+    CHECK(view(path_lens<model, int>("tags/home"), m) == std::nullopt);
+}
+
+TEST_CASE("path lens, json pointers")
+{
+    auto m = model{{{false, "foo"}}, {{"a/b", 1}}, {}, {}};
+
+    CHECK(view(path_lens<model, std::string>("/todos/0/text"), m) == "foo");
+    CHECK(view(path_lens<model, int>("/tags/a~1b"), m) == 1);
+}
+
+TEST_CASE("path lens, optionals and variants")
+{
+    auto m = model{{}, {}, {}, note{5}};
+
+    auto done = path_lens<model, bool>("current/done");
+    CHECK(view(done, m) == std::nullopt);
+    m.current = todo{true, "foo"};
+    CHECK(view(done, m) == true);
+
+    CHECK(view(path_lens<model, int>("item/1/priority"), m) == 5);
+    CHECK(view(path_lens<model, std::string>("item/0/text"), m) ==
+          std::nullopt);
+}
+
+TEST_CASE("path lens, invalid paths")
+{
+    CHECK_THROWS_AS((path_lens<model, int>("todos/0/text")),
+                    std::invalid_argument);
+    CHECK_THROWS_AS((path_lens<model, int>("nope")), std::invalid_argument);
+    CHECK_THROWS_AS((path_lens<model, std::string>("todos/x/text")),
+                    std::invalid_argument);
+}
+
+TEST_CASE("path lens, cached paths do not keep the argument")
+{
+    auto m = model{{{false, "foo"}}, {}, {}, {}};
+
+    auto path = std::string{"todos/0/text"};
+    auto l1   = path_lens<model, std::string>(path);
+    path      = "todos/0/done";
+    CHECK(view(path_lens<model, bool>(path), m) == false);
+    path.clear();
+    CHECK(view(l1, m) == "foo");
+    CHECK(view(path_lens<model, std::string>("todos/0/text"), m) == "foo");
+}
@@ -0,0 +1,178 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+
+#include <catch2/catch.hpp>
+
+#include <lager/extra/snapshot.hpp>
+#include <lager/extra/struct.hpp>
+
+#include <immer/box.hpp>
+#include <immer/flex_vector.hpp>
+#include <immer/map.hpp>
+#include <immer/set.hpp>
+#include <immer/vector.hpp>
+
+#include <cstdio>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace ns {
+
+enum class color
+{
+    red,
+    green
+};
+
+struct item
+{
+    std::string text;
+    bool done;
+    color tag;
+};
+
+struct doc
+{
+    std::vector<item> items;
+    std::vector<double> samples;
+    std::map<std::string, int> counts;
+    std::optional<std::string> title;
+    std::variant<int, std::string> selection;
+};
+
+struct selection
+{
+    bool visible;
+    std::set<int> ids;
+};
+
+struct persistent_doc
+{
+    immer::vector<item> items;
+    immer::flex_vector<float> samples;
+    immer::map<std::string, int> counts;
+    immer::set<int> ids;
+    immer::box<std::string> title;
+};
+
+} // namespace ns
+
+LAGER_STRUCT(ns, item, text, done, tag);
+LAGER_STRUCT(ns, doc, items, samples, counts, title, selection);
+LAGER_STRUCT(ns, selection, visible, ids);
+LAGER_STRUCT(ns, persistent_doc, items, samples, counts, ids, title);
+
+namespace {
+
+ns::doc make_doc()
+{
+    return {{{"foo", false, ns::color::red}, {"bar", true, ns::color::green}},
+            {1.5, 2.5, 3.5},
+            {{"a", 1}, {"b", 2}},
+            "title",
+            std::string{"foo"}};
+}
+
+} // namespace
+
+TEST_CASE("snapshot, round trip")
+{
+    auto x    = make_doc();
+    auto data = lager::make_snapshot(x);
+    auto y    = lager::read_snapshot<ns::doc>(data.data(), data.size());
+    CHECK(x == y);
+}
+
+TEST_CASE("snapshot, round trip of sets after unaligned values")
+{
+    auto x    = ns::selection{true, {1, 2, 42}};
+    auto data = lager::make_snapshot(x);
+    auto y    = lager::read_snapshot<ns::selection>(data.data(), data.size());
+    CHECK(x == y);
+}
+
+TEST_CASE("snapshot, round trip of immer containers")
+{
+    auto x = ns::persistent_doc{
+        {{"foo", false, ns::color::red}, {"bar", true, ns::color::green}},
+        {},
+        {},
+        {},
+        std::string{"title"}};
+    for (auto i = 0; i < 1000; ++i) {
+        x.samples = std::move(x.samples).push_back(i * 0.5f);
+        x.counts  = std::move(x.counts).set(std::to_string(i), i);
+        x.ids     = std::move(x.ids).insert(i * 7);
+    }
+    auto data = lager::make_snapshot(x);
+    auto y =
+        lager::read_snapshot<ns::persistent_doc>(data.data(), data.size());
+    CHECK(x == y);
+    CHECK(y.samples.size() == 1000);
+    CHECK(y.samples[999] == 499.5f);
+    CHECK(y.counts.size() == 1000);
+    CHECK(y.counts.at("42") == 42);
+    CHECK(y.ids.size() == 1000);
+    CHECK(y.ids.count(42));
+    CHECK(y.title.get() == "title");
+}
+
+TEST_CASE("snapshot, round trip through a file")
+{
+    auto fname = std::string{"lager-test-snapshot.bin"};
+    auto x     = make_doc();
+    lager::save_snapshot(fname, x, 42);
+    auto y = lager::load_snapshot<ns::doc>(fname, 42);
+    CHECK(x == y);
+    CHECK_THROWS_AS(lager::load_snapshot<ns::doc>(fname, 43),
+                    lager::snapshot_error);
+    std::remove(fname.c_str());
+    CHECK_THROWS_AS(lager::load_snapshot<ns::doc>(fname, 42),
+                    lager::snapshot_error);
+}
+
+TEST_CASE("snapshot, invalid data")
+{
+    auto data = lager::make_snapshot(make_doc());
+    auto load = [](const std::vector<char>& d) {
+        return lager::read_snapshot<ns::doc>(d.data(), d.size());
+    };
+
+    SECTION("corrupted")
+    {
+        data.back() ^= 1;
+        CHECK_THROWS_AS(load(data), lager::snapshot_error);
+    }
+
+    SECTION("truncated")
+    {
+        data.pop_back();
+        CHECK_THROWS_AS(load(data), lager::snapshot_error);
+    }
+
+    SECTION("empty")
+    {
+        CHECK_THROWS_AS(load({}), lager::snapshot_error);
+    }
+
+    SECTION("another type")
+    {
+        CHECK_THROWS_AS((lager::read_snapshot<ns::item>(data.data(),
+                                                        data.size())),
+                        lager::snapshot_error);
+    }
+}
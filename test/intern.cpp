@@ -0,0 +1,85 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch2/catch.hpp>
+
+#include <lager/intern.hpp>
+#include <lager/lenses/attr.hpp>
+#include <lager/state.hpp>
+
+#include <zug/transducer/map.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace lager;
+
+namespace {
+
+struct model
+{
+    std::vector<int> todos;
+    int counter = 0;
+};
+
+template <typename A, typename B>
+bool same_node(const A& a, const B& b)
+{
+    return detail::access::node(a) == detail::access::node(b);
+}
+
+} // namespace
+
+TEST_CASE("intern, reuses live nodes")
+{
+    auto st = make_state(model{{1, 2, 3}, 0}, automatic_tag{});
+    auto a  = intern(st, &model::todos);
+    auto b  = intern(st, &model::todos);
+    auto c  = intern(st, &model::counter);
+    CHECK(same_node(a, b));
+    CHECK(!same_node(a, st[&model::todos].make()));
+    CHECK(a.get() == std::vector<int>{1, 2, 3});
+    CHECK(c.get() == 0);
+
+    b.set(std::vector<int>{4});
+    CHECK(a.get() == std::vector<int>{4});
+}
+
+TEST_CASE("intern, entries expire with their users")
+{
+    auto st   = make_state(model{}, automatic_tag{});
+    auto weak = std::weak_ptr<detail::reader_node_base>{};
+    {
+        auto a = intern(st, &model::counter);
+        weak   = detail::access::node(a);
+    }
+    CHECK(weak.expired());
+    auto b = intern(st, &model::counter);
+    b.set(42);
+    CHECK(st.get().counter == 42);
+}
+
+TEST_CASE("intern, zoom and xform with keys")
+{
+    auto st = make_state(model{{1, 2}, 5}, automatic_tag{});
+    auto l1 = intern_zoom(st, 0, lenses::attr(&model::counter));
+    auto l2 = intern_zoom(st, 0, lenses::attr(&model::counter));
+    CHECK(same_node(l1, l2));
+
+    auto twice = [](const model& m) { return m.counter * 2; };
+    auto x1    = intern_xform(st, std::string{"twice"}, zug::map(twice));
+    auto x2    = intern_xform(st, std::string{"twice"}, zug::map(twice));
+    auto x3    = intern_xform(st, std::string{"other"}, zug::map(twice));
+    CHECK(same_node(x1, x2));
+    CHECK(!same_node(x1, x3));
+    CHECK(x1.get() == 10);
+}
@@ -12,6 +12,9 @@
 
 #include <catch2/catch.hpp>
 
+#include <immer/flex_vector.hpp>
+#include <immer/map.hpp>
+#include <immer/set.hpp>
 #include <immer/vector.hpp>
 #include <zug/compose.hpp>
 #include <zug/util.hpp>
@@ -21,10 +24,13 @@
 #include <lager/lenses/at_or.hpp>
 #include <lager/lenses/attr.hpp>
 #include <lager/lenses/optional.hpp>
+#include <lager/lenses/traversal.hpp>
 #include <lager/lenses/tuple.hpp>
 #include <lager/lenses/variant.hpp>
 
 #include <array>
+#include <set>
+#include <type_traits>
 
 struct yearday
 {
@@ -216,6 +222,55 @@ TEST_CASE("lenses, at immutable index")
     CHECK(view(first_name, set(first_name, v1, "bar")) == "bar");
 }
 
+TEST_CASE("lenses, at immutable key")
+{
+    auto first_name = at(1) | with_opt(attr(&person::name));
+
+    auto m1 = immer::map<int, person>{};
+    CHECK(view(first_name, m1) == std::nullopt);
+    CHECK(set(first_name, m1, "foo").empty());
+
+    m1 = m1.set(1, {{}, "foo"});
+    CHECK(view(first_name, m1) == "foo");
+    CHECK(view(first_name, set(first_name, m1, "bar")) == "bar");
+    CHECK(view(first_name, over(first_name, m1, [](auto x) {
+              return x ? std::optional{*x + "!"} : x;
+          })) == "foo!");
+}
+
+TEST_CASE("lenses, at_unchecked")
+{
+    auto first_name = at_unchecked(0) | attr(&person::name);
+
+    auto v1 = immer::vector<person>{{{}, "foo"}};
+    CHECK(&view(at_unchecked(0), v1) == &v1[0]);
+    CHECK(view(first_name, v1) == "foo");
+    CHECK(view(first_name, set(first_name, v1, "bar")) == "bar");
+    CHECK(view(first_name, over(first_name, v1, [](auto x) {
+              return x + "!";
+          })) == "foo!");
+
+    auto v2 = std::vector<person>{{{}, "foo"}};
+    CHECK(view(first_name, set(first_name, v2, "bar")) == "bar");
+}
+
+TEST_CASE("lenses, at_unchecked missing key throws")
+{
+    auto first_name = at_unchecked(1) | attr(&person::name);
+
+    auto v1 = immer::vector<person>{{{}, "foo"}};
+    CHECK_THROWS_AS(view(first_name, v1), std::out_of_range);
+    CHECK_THROWS_AS(set(first_name, v1, "bar"), std::out_of_range);
+
+    auto v2 = std::vector<person>{{{}, "foo"}};
+    CHECK_THROWS_AS(view(first_name, v2), std::out_of_range);
+    CHECK_THROWS_AS(set(first_name, v2, "bar"), std::out_of_range);
+
+    auto m = immer::map<int, person>{}.set(0, {{}, "foo"});
+    CHECK_THROWS_AS(view(first_name, m), std::out_of_range);
+    CHECK_THROWS_AS(set(first_name, m, "bar"), std::out_of_range);
+}
+
 TEST_CASE("lenses, at_or default")
 {
     auto first      = at_or(0);
@@ -248,6 +303,41 @@ TEST_CASE("lenses, at_or")
     CHECK(view(first_name, set(first_name, v1, "bar")) == "bar");
 }
 
+TEST_CASE("lenses, at_or copies only when needed")
+{
+    auto v1 = immer::vector<person>{{{}, "foo"}};
+    CHECK(&view(at_or(0), v1) == &v1[0]);
+    CHECK(&view(at_or(1), v1) == &view(at_or(2), v1));
+
+
+    auto fallback = at_or(1, person{{}, "null"});
+    static_assert(!std::is_reference_v<decltype(view(fallback, v1))>);
+    static_assert(!std::is_reference_v<decltype(view(
+                      at_or(0), immer::vector<person>{}))>);
+    CHECK(view(fallback, v1).name == "null");
+}
+
+TEST_CASE("lenses, at_or_else")
+{
+    auto calls = 0;
+    auto first = at_or_else(0, [&] {
+        ++calls;
+        return person{{}, "null"};
+    });
+    auto first_name = first | attr(&person::name);
+
+    auto v1 = immer::vector<person>{};
+    CHECK(view(first_name, v1) == "null");
+    CHECK(calls == 1);
+    CHECK(view(first_name, set(first_name, v1, "bar")) == "null");
+
+    v1    = v1.push_back({{}, "foo"});
+    calls = 0;
+    CHECK(view(first_name, v1) == "foo");
+    CHECK(view(first_name, set(first_name, v1, "bar")) == "bar");
+    CHECK(calls == 0);
+}
+
 TEST_CASE("lenses, value_or")
 {
     auto first      = at(0);
@@ -624,3 +714,66 @@ TEST_CASE("lenses::element array", "[lenses][element][array]")
 
     CHECK(over(element<1>, foo, increment) == (std::array{1, 3, 3}));
 }
+
+TEST_CASE("lenses::each", "[lenses][traversal]")
+{
+    auto names = each | attr(&person::name);
+
+    auto v1 = immer::flex_vector<person>{{{}, "foo"}, {{}, "bar"}};
+    CHECK(view(names, v1) == std::vector<std::string>{"foo", "bar"});
+    CHECK(view(names, set(names, v1, "baz")) ==
+          std::vector<std::string>{"baz", "baz"});
+    CHECK(view(names, over(names, v1, [](auto x) { return x + "!"; })) ==
+          std::vector<std::string>{"foo!", "bar!"});
+
+    auto v2 = std::vector<person>{{{}, "foo"}};
+    CHECK(view(names, set(names, v2, "baz")) ==
+          std::vector<std::string>{"baz"});
+
+    auto m1 = immer::map<int, int>{}.set(1, 1).set(2, 2);
+    CHECK(view(each, over(each, m1, increment)).size() == 2);
+    CHECK(over(each, m1, increment)[2] == 3);
+}
+
+TEST_CASE("lenses::each, sets", "[lenses][traversal]")
+{
+    auto s1 = immer::set<int>{1, 2, 3};
+    CHECK(over(each, s1, increment) == immer::set<int>{2, 3, 4});
+    CHECK(set(each, s1, 0) == immer::set<int>{0});
+
+    auto s2 = std::set<int>{1, 2, 3};
+    CHECK(over(each, s2, increment) == std::set<int>{2, 3, 4});
+    CHECK(over(filtered([](int x) { return x > 1; }), s2, increment) ==
+          std::set<int>{1, 3, 4});
+}
+
+TEST_CASE("lenses::filtered", "[lenses][traversal]")
+{
+    auto in_may = filtered([](const person& p) {
+        return p.birthday.month == 5;
+    });
+    auto names = in_may | attr(&person::name);
+
+    auto v1 = immer::vector<person>{
+        {{1, 5}, "foo"}, {{2, 6}, "bar"}, {{3, 5}, "baz"}};
+    CHECK(view(names, v1) == std::vector<std::string>{"foo", "baz"});
+
+    auto v2 = set(names, v1, "may");
+    CHECK(view(each | attr(&person::name), v2) ==
+          std::vector<std::string>{"may", "bar", "may"});
+}
+
+TEST_CASE("lenses::keys", "[lenses][traversal]")
+{
+    auto v1 = immer::vector<int>{1, 2, 3};
+    CHECK(view(keys(std::vector<int>{2, 0, 5}), v1) ==
+          std::vector<int>{3, 1});
+    CHECK(over(keys(std::vector<int>{2, 0, 5}), v1, increment) ==
+          immer::vector<int>{2, 2, 4});
+
+    auto m1 = immer::map<std::string, int>{}.set("a", 1).set("b", 2);
+    auto m2 = over(keys(std::vector<std::string>{"b", "c"}), m1, increment);
+    CHECK(m2.size() == 2);
+    CHECK(m2["a"] == 1);
+    CHECK(m2["b"] == 3);
+}
@@ -0,0 +1,96 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch2/catch.hpp>
+
+#include <lager/detail/lru_cache.hpp>
+#include <lager/memo.hpp>
+#include <lager/state.hpp>
+#include <lager/with.hpp>
+
+#include <stdexcept>
+#include <string>
+
+using namespace lager;
+
+TEST_CASE("map_memo, skips recomputation of recent values")
+{
+    auto calls = 0;
+    auto x     = make_state(0, automatic_tag{});
+    auto y     = x.map_memo(
+                  [&](int v) {
+                      ++calls;
+                      return std::to_string(v);
+                  },
+                  2)
+                 .make();
+    CHECK(y.get() == "0");
+    calls = 0;
+
+    x.set(1);
+    CHECK(y.get() == "1");
+    CHECK(calls == 1);
+    x.set(2);
+    CHECK(y.get() == "2");
+    CHECK(calls == 2);
+    x.set(1);
+    CHECK(y.get() == "1");
+    CHECK(calls == 2);
+
+    // 2 is the least recently used, so it is evicted
+    x.set(3);
+    CHECK(y.get() == "3");
+    CHECK(calls == 3);
+    x.set(1);
+    CHECK(calls == 3);
+    x.set(2);
+    CHECK(y.get() == "2");
+    CHECK(calls == 4);
+}
+
+TEST_CASE("map_memo, multiple parents")
+{
+    auto calls = 0;
+    auto x     = make_state(1, automatic_tag{});
+    auto y     = make_state(2, automatic_tag{});
+    auto z     = with(x, y)
+                 .xform(map_memo([&](int a, int b) {
+                     ++calls;
+                     return a * 10 + b;
+                 }))
+                 .make();
+    calls = 0;
+
+    x.set(3);
+    CHECK(z.get() == 32);
+    y.set(4);
+    CHECK(z.get() == 34);
+    x.set(1);
+    y.set(2);
+    CHECK(z.get() == 12);
+    CHECK(calls == 4);
+    x.set(3);
+    CHECK(z.get() == 32);
+    CHECK(calls == 4);
+}
+
+TEST_CASE("lru_cache, failed computations do not evict")
+{
+    auto cache = detail::lru_cache<int, std::string>{1};
+    CHECK(cache.get(1, [] { return std::string{"one"}; }) == "one");
+    CHECK_THROWS(cache.get(2, []() -> std::string {
+        throw std::runtime_error{"noo!"};
+    }));
+    CHECK(cache.size() == 1);
+    REQUIRE(cache.find(1));
+    CHECK(*cache.find(1) == "one");
+}
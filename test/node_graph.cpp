@@ -0,0 +1,87 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#define LAGER_ENABLE_NODE_STATS 1
+
+#include <catch2/catch.hpp>
+
+#include <lager/debug/node_graph.hpp>
+#include <lager/state.hpp>
+#include <lager/with.hpp>
+
+#include <zug/transducer/map.hpp>
+
+#include <sstream>
+#include <tuple>
+
+using namespace lager;
+
+TEST_CASE("node graph, collects nodes and stats")
+{
+    auto x      = make_state(0, automatic_tag{});
+    auto y      = make_state(10, automatic_tag{});
+    auto parity = x.xform(zug::map([](int v) { return v % 2; })).make();
+    auto both   = with(x, y).make();
+    watch(parity, [](int) {});
+
+    x.set(1);
+    x.set(3);
+
+    auto graph = inspect_node_graph(x, y);
+    REQUIRE(graph.nodes.size() == 4);
+
+    CHECK(graph.nodes[0].kind == "state");
+    CHECK(graph.nodes[0].value_type == "int");
+    CHECK(graph.nodes[0].changes == 2);
+    CHECK(graph.nodes[0].children == std::vector<std::size_t>{2, 3});
+
+    CHECK(graph.nodes[1].kind == "state");
+    CHECK(graph.nodes[1].changes == 0);
+    CHECK(graph.nodes[1].children == std::vector<std::size_t>{3});
+
+    CHECK(graph.nodes[2].kind == "xform");
+    CHECK(graph.nodes[2].recomputes == 2);
+    CHECK(graph.nodes[2].changes == 1);
+    CHECK(graph.nodes[2].observers == 1);
+
+    CHECK(graph.nodes[3].kind == "merge");
+    CHECK(graph.nodes[3].recomputes == 2);
+    CHECK(graph.nodes[3].changes == 2);
+    CHECK(graph.nodes[3].observers == 0);
+}
+
+TEST_CASE("node graph, export")
+{
+    auto x = make_state(0, automatic_tag{});
+    auto y = x.xform(zug::map([](int v) { return v + 1; })).make();
+
+    auto graph = inspect_node_graph(x);
+    REQUIRE(graph.nodes.size() == 2);
+
+    auto json = std::ostringstream{};
+    write_json(json, graph);
+    CHECK(json.str() ==
+          "{\"nodes\":[\n"
+          "{\"id\":0,\"kind\":\"state\",\"value_type\":\"int\","
+          "\"recomputes\":0,\"changes\":0,\"recompute_time\":0,"
+          "\"observers\":0,\"children\":[1]},\n"
+          "{\"id\":1,\"kind\":\"xform\",\"value_type\":\"int\","
+          "\"recomputes\":0,\"changes\":0,\"recompute_time\":0,"
+          "\"observers\":0,\"children\":[]}\n"
+          "]}\n");
+
+    auto dot = std::ostringstream{};
+    write_dot(dot, graph);
+    CHECK(dot.str().find("n0 -> n1;") != std::string::npos);
+    CHECK(dot.str().find("label=\"xform: int\\nrecomputes: 0") !=
+          std::string::npos);
+}
@@ -0,0 +1,95 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch2/catch.hpp>
+
+#include <lager/projection.hpp>
+#include <lager/state.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace lager;
+
+namespace {
+
+struct inner
+{
+    std::vector<int> values;
+    int counter = 0;
+};
+
+struct model
+{
+    inner in;
+    std::string name;
+};
+
+} // namespace
+
+TEST_CASE("projection, refers to the parent value")
+{
+    auto st = make_state(model{{{1, 2}, 3}, "foo"}, automatic_tag{});
+    auto in = project(st, &model::in);
+    auto xs = project(in, &inner::values);
+    CHECK(xs.get() == std::vector<int>{1, 2});
+    CHECK(&xs.get() == &st.get().in.values);
+
+    st.set(model{{{4}, 3}, "foo"});
+    CHECK(xs.get() == std::vector<int>{4});
+    CHECK(&xs.get() == &st.get().in.values);
+}
+
+TEST_CASE("projection, notifies only changes of the part")
+{
+    auto st      = make_state(model{{{1, 2}, 3}, "foo"}, automatic_tag{});
+    auto counter = project(project(st, &model::in), &inner::counter);
+    auto name    = project(st, &model::name);
+    auto seen    = std::vector<int>{};
+    auto names   = 0;
+    watch(counter, [&](int x) { seen.push_back(x); });
+    watch(name, [&](auto&&) { ++names; });
+
+    st.update([](model m) {
+        m.in.counter = 5;
+        return m;
+    });
+    st.update([](model m) {
+        m.in.values.push_back(3);
+        return m;
+    });
+    st.update([](model m) {
+        m.in.counter = 6;
+        return m;
+    });
+    CHECK(seen == std::vector<int>{5, 6});
+    CHECK(names == 0);
+}
+
+TEST_CASE("projection, derived nodes and transactions")
+{
+    auto st    = make_state(std::pair{1, std::string{"a"}});
+    auto first = project<0>(st);
+    auto twice = first.map([](int x) { return x * 2; }).make();
+    auto seen  = std::vector<int>{};
+    watch(twice, [&](int x) { seen.push_back(x); });
+
+    st.set(std::pair{2, std::string{"a"}});
+    CHECK(first.get() == 1);
+    CHECK(twice.get() == 2);
+
+    commit(st);
+    CHECK(first.get() == 2);
+    CHECK(twice.get() == 4);
+    CHECK(seen == std::vector<int>{4});
+}
@@ -0,0 +1,128 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch2/catch.hpp>
+
+#include <lager/event_loop/queue.hpp>
+#include <lager/extra/chrome_trace.hpp>
+#include <lager/store.hpp>
+
+#include "../example/counter/counter.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+auto phases_of(const lager::trace_ring_buffer& buffer)
+{
+    auto events = buffer.events();
+    auto result = std::vector<lager::trace_phase>{};
+    std::transform(events.begin(),
+                   events.end(),
+                   std::back_inserter(result),
+                   [](auto&& ev) { return ev.phase; });
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("tracing records the phases of each action")
+{
+    auto buffer = lager::trace_ring_buffer{};
+    auto queue  = lager::queue_event_loop{};
+    auto store  = lager::make_store<counter::action>(
+        counter::model{},
+        lager::with_queue_event_loop{queue},
+        lager::with_tracing(buffer));
+
+    store.dispatch(counter::increment_action{});
+    store.dispatch(counter::increment_action{});
+    queue.step();
+    CHECK(store->value == 2);
+
+    using ph = lager::trace_phase;
+    CHECK(phases_of(buffer) == std::vector<ph>{ph::queue,
+                                               ph::reducer,
+                                               ph::queue,
+                                               ph::reducer,
+                                               ph::send_down,
+                                               ph::notify,
+                                               ph::send_down,
+                                               ph::notify});
+
+    auto events = buffer.events();
+    CHECK(events[0].action_id == 0);
+    CHECK(events[2].action_id == 1);
+    CHECK(std::all_of(events.begin(), events.end(), [](auto&& ev) {
+        return ev.begin <= ev.end;
+    }));
+}
+
+TEST_CASE("tracing records effects")
+{
+    auto buffer = lager::trace_ring_buffer{};
+    auto queue  = lager::queue_event_loop{};
+    auto store  = lager::make_store<int>(
+        0,
+        lager::with_queue_event_loop{queue},
+        lager::with_futures,
+        lager::with_tracing(buffer),
+        lager::with_reducer([](int s, int a) -> lager::result<int, int> {
+            return {s + a, [](auto&&) {}};
+        }));
+
+    auto called = 0;
+    store.dispatch(1).then([&] { ++called; });
+    queue.step();
+    CHECK(called == 1);
+
+    using ph = lager::trace_phase;
+    CHECK(phases_of(buffer) == std::vector<ph>{ph::queue,
+                                               ph::reducer,
+                                               ph::send_down,
+                                               ph::notify,
+                                               ph::effect,
+                                               ph::effect_future});
+}
+
+TEST_CASE("ring buffer keeps the most recent events")
+{
+    auto buffer = lager::trace_ring_buffer{2};
+    buffer.record({0, 1, 0, lager::trace_phase::reducer});
+    buffer.record({1, 2, 1, lager::trace_phase::reducer});
+    buffer.record({2, 3, 2, lager::trace_phase::reducer});
+
+    auto events = buffer.events();
+    REQUIRE(events.size() == 2);
+    CHECK(events[0].action_id == 1);
+    CHECK(events[1].action_id == 2);
+}
+
+TEST_CASE("chrome trace export")
+{
+    auto out = std::ostringstream{};
+    {
+        auto sink = lager::chrome_trace_sink{out};
+        sink.record({1000, 3500, 7, lager::trace_phase::reducer});
+        sink.record({0, 1000, 7, lager::trace_phase::queue});
+    }
+    CHECK(out.str() ==
+          "{\"traceEvents\":[\n"
+          "{\"name\":\"reducer\",\"cat\":\"lager\",\"ph\":\"X\",\"pid\":1,"
+          "\"tid\":1,\"ts\":1.000,\"dur\":2.500,\"args\":{\"action\":7}},\n"
+          "{\"name\":\"queue\",\"cat\":\"lager\",\"ph\":\"b\",\"pid\":1,"
+          "\"tid\":1,\"ts\":0.000,\"id\":7},\n"
+          "{\"name\":\"queue\",\"cat\":\"lager\",\"ph\":\"e\",\"pid\":1,"
+          "\"tid\":1,\"ts\":1.000,\"id\":7}\n"
+          "]}\n");
+}
@@ -12,6 +12,7 @@
 
 #include <catch2/catch.hpp>
 
+#include <array>
 #include <vector>
 
 #include <zug/compose.hpp>
@@ -165,3 +166,60 @@ TEST_CASE("type erased lenses, nesting")
         CHECK(view(lens, set(lens, t1, expected)) == expected);
     }
 }
+
+TEST_CASE("type erased lenses, copy and move")
+{
+    using te_lens = lens<tree, size_t>;
+
+    te_lens value = attr(&tree::value);
+    te_lens first = attr(&tree::pair) | attr(&val_pair::first);
+
+    auto t1 = tree{42, {256, 1115}};
+
+    auto copied = first;
+    CHECK(view(copied, t1) == 256);
+    CHECK(view(first, t1) == 256);
+
+    auto moved = std::move(copied);
+    CHECK(view(moved, t1) == 256);
+
+    copied = value;
+    CHECK(view(copied, t1) == 42);
+    copied = std::move(moved);
+    CHECK(view(copied, t1) == 256);
+    CHECK(view(copied, set(copied, t1, 5)) == 5);
+}
+
+TEST_CASE("type erased lenses, big lenses")
+{
+    auto padding = std::array<size_t, 32>{};
+    auto big     = getset(
+        [padding](const tree& t) { return t.value + padding[0]; },
+        [padding](tree t, size_t v) {
+            t.value = v + padding[1];
+            return t;
+        });
+    lens<tree, size_t> te_big = big;
+
+    auto t1     = tree{42};
+    auto copied = te_big;
+    auto moved  = std::move(te_big);
+    CHECK(view(copied, t1) == 42);
+    CHECK(view(moved, set(copied, t1, 7)) == 7);
+    CHECK(view(moved, over(copied, t1, [](auto x) { return x + 1; })) == 43);
+}
+
+TEST_CASE("type erased lenses, set rvalues")
+{
+    lens<tree, immer::vector<immer::box<tree>>> children =
+        attr(&tree::children);
+
+    auto t1 = set(children, tree{1}, immer::vector<immer::box<tree>>{tree{2}});
+    CHECK(view(children, t1).size() == 1);
+
+    auto t2 = over(children, std::move(t1), [](auto vec) {
+        return std::move(vec).push_back(tree{3});
+    });
+    CHECK(view(children, t2).size() == 2);
+    CHECK(view(children, t2)[1]->value == 3);
+}
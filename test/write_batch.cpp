@@ -0,0 +1,173 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch2/catch.hpp>
+
+#include <lager/state.hpp>
+#include <lager/write_batch.hpp>
+
+#include <stdexcept>
+
+using namespace lager;
+
+namespace {
+
+struct point
+{
+    int x = 0;
+    int y = 0;
+
+    bool operator==(const point& other) const
+    {
+        return x == other.x && y == other.y;
+    }
+};
+
+struct model
+{
+    point a;
+    point b;
+
+    bool operator==(const model& other) const
+    {
+        return a == other.a && b == other.b;
+    }
+};
+
+struct counted
+{
+    static inline int copies = 0;
+
+    counted()          = default;
+    counted(counted&&) = default;
+    counted& operator=(counted&&) = default;
+    counted(const counted&) { ++copies; }
+    counted& operator=(const counted&)
+    {
+        ++copies;
+        return *this;
+    }
+
+    bool operator==(const counted&) const { return true; }
+};
+
+struct wide
+{
+    point a;
+    point b;
+    int n = 0;
+    counted c;
+
+    bool operator==(const wide& other) const
+    {
+        return a == other.a && b == other.b && n == other.n;
+    }
+};
+
+} // namespace
+
+TEST_CASE("write batch, applies writes when flushed")
+{
+    auto st       = make_state(model{}, automatic_tag{});
+    auto ax       = st[&model::a][&point::x].make();
+    auto by       = st[&model::b][&point::y].make();
+    auto notified = 0;
+    watch(st, [&](auto&&) { ++notified; });
+    {
+        auto batch = write_batch{};
+        for (auto i = 0; i < 10; ++i) {
+            ax.set(i);
+            by.update([](int y) { return y + 1; });
+        }
+        CHECK(st.get() == model{});
+        CHECK(notified == 0);
+    }
+    CHECK(st.get() == model{{9, 0}, {0, 10}});
+    CHECK(ax.get() == 9);
+    CHECK(by.get() == 10);
+    CHECK(notified == 1);
+}
+
+TEST_CASE("write batch, flushed on commit")
+{
+    auto st    = make_state(model{});
+    auto ay    = st[&model::a][&point::y].make();
+    auto batch = write_batch{};
+    ay.set(42);
+    CHECK(st.get() == model{});
+    commit(st);
+    CHECK(st.get() == model{{0, 42}, {}});
+    CHECK(ay.get() == 42);
+}
+
+TEST_CASE("write batch, keeps the order of writes")
+{
+    auto st = make_state(model{}, automatic_tag{});
+    auto a  = st[&model::a].make();
+    auto ax = a[&point::x].make();
+    auto ay = a[&point::y].make();
+    {
+        auto batch = write_batch{};
+        ax.set(1);
+        a.set(point{5, 5});
+        ay.set(2);
+    }
+    CHECK(st.get() == model{{5, 2}, {}});
+    {
+        auto batch = write_batch{};
+        ax.set(3);
+        st.set(model{});
+    }
+    CHECK(st.get() == model{});
+}
+
+TEST_CASE("write batch, discarded on exceptions")
+{
+    auto st = make_state(model{}, automatic_tag{});
+    auto ax = st[&model::a][&point::x].make();
+    try {
+        auto batch = write_batch{};
+        ax.set(1);
+        throw std::runtime_error{"oops"};
+    } catch (const std::runtime_error&) {
+    }
+    CHECK(st.get() == model{});
+    CHECK(ax.get() == 0);
+    ax.update([](int x) { return x + 1; });
+    CHECK(st.get() == model{{1, 0}, {}});
+}
+
+TEST_CASE("write batch, rebuilds the parent of sibling cursors once")
+{
+    auto st     = make_state(wide{}, automatic_tag{});
+    auto a      = st[&wide::a].make();
+    auto by     = st[&wide::b][&point::y].make();
+    auto n      = st[&wide::n].make();
+    auto copies = [&](auto fn) {
+        counted::copies = 0;
+        {
+            auto batch = write_batch{};
+            fn();
+        }
+        return counted::copies;
+    };
+    auto one = copies([&] { n.set(1); });
+    auto all = copies([&] {
+        for (auto i = 0; i < 10; ++i) {
+            a.set(point{i, i});
+            by.set(i);
+            n.set(i);
+        }
+    });
+    CHECK(all == one);
+    CHECK(st.get() == wide{{9, 9}, {0, 9}, 9, {}});
+}
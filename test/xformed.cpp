@@ -155,6 +155,24 @@ TEST_CASE("xformed, one arg filter without value")
     CHECK(x.get() == 0);
 }
 
+TEST_CASE("xformed, filter without value does not throw")
+{
+    auto s = state<int>{43};
+    auto x = reader<int>{s};
+    CHECK_NOTHROW(x = s.filter([](int a) { return a % 2 == 0; }).make());
+    CHECK(x.get() == 0);
+
+    auto t    = state<int>{1};
+    auto y    = reader<std::tuple<int, int>>{with(s, t)};
+    auto less = [](int a, int b) { return a < b; };
+    CHECK_NOTHROW(y = with(s, t).xform(filter(less)).make());
+    CHECK(y.get() == std::make_tuple(0, 0));
+
+    s.set(44);
+    commit(s);
+    CHECK(x.get() == 44);
+}
+
 struct non_default
 {
     int v         = 0;